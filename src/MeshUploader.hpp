@@ -0,0 +1,270 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "dependencies/glfw-3.4/deps/glad/gl.h"
+
+#include "include/common/graphics.hpp"
+#include "include/common/compact_mesh.hpp"
+
+/**
+ * Owns a vertex buffer & an index buffer and streams meshes into them. Buffers grow by doubling, so
+ * steady state uploads never reallocate driver storage, and an upload is skipped entirely when the
+ * mesh's revision hasn't changed since the last one.
+ *
+ * Two strategies are available:
+ *
+ * Orphan: each upload orphans the buffer (glBufferData with a null pointer, same size) then writes
+ *  with glBufferSubData, so the driver can hand out fresh storage while the GPU still reads the old.
+ *
+ * MappedRing: the buffers are split into `segments` regions written round-robin through unsynchronized
+ *  glMapBufferRange. A fence guards every region, so a region is only rewritten once the GPU is done
+ *  drawing from it. Falls back to Orphan if the context lacks sync objects (OpenGL 3.2).
+ *
+ * Draw with `MeshUploader::draw` so the current region's offsets are used. The vertex attributes of the
+ * bound VAO must point at `vertex_buffer()` with offsets relative to the start of a vertex.
+ */
+class MeshUploader {
+public:
+    enum class Strategy {
+        Orphan,
+        MappedRing
+    };
+
+private:
+    static constexpr size_t MAX_SEGMENTS = 4;
+
+    GLuint vbo = 0;
+    GLuint ebo = 0;
+    Strategy strategy;
+    size_t segments;
+
+    size_t vertex_capacity = 0;     // bytes per segment
+    size_t index_capacity = 0;      // bytes per segment
+    size_t segment = 0;
+    std::array<GLsync, MAX_SEGMENTS> fences = {};
+
+    uint64_t uploaded_revision = 0;
+    bool has_uploaded = false;
+
+    size_t vertex_stride = sizeof(mbl::common::graphics::Vertex);
+    size_t index_count = 0;
+    GLenum index_type = GL_UNSIGNED_INT;
+
+    static size_t grown_capacity(const size_t current, const size_t required) {
+        size_t capacity = current == 0 ? 1024 : current;
+        while (capacity < required) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    void clear_fences() {
+        for (GLsync& fence : fences) {
+            if (fence != nullptr) {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+    }
+
+    /** Makes sure each segment of `target`'s buffer holds at least `required` bytes, doubling if not.
+     * Returns true if the buffer was reallocated. */
+    bool reserve(const GLenum target, size_t& capacity, const size_t required, const size_t alignment) {
+        if (required <= capacity) {
+            return false;
+        }
+
+        capacity = grown_capacity(capacity, required);
+        capacity += (alignment - capacity % alignment) % alignment;
+        glBufferData(target, (GLsizeiptr) (capacity * segments), nullptr, GL_STREAM_DRAW);
+        return true;
+    }
+
+    void write_orphaned(const GLenum target, const size_t capacity, const void* data, const size_t bytes) {
+        glBufferData(target, (GLsizeiptr) capacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(target, 0, (GLsizeiptr) bytes, data);
+    }
+
+    void write_mapped(const GLenum target, const size_t capacity, const void* data, const size_t bytes) {
+        if (bytes == 0) {
+            return;
+        }
+
+        const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+        void* dst = glMapBufferRange(target, (GLintptr) (segment * capacity), (GLsizeiptr) bytes, access);
+        if (dst == nullptr) {
+            glBufferSubData(target, (GLintptr) (segment * capacity), (GLsizeiptr) bytes, data);
+            return;
+        }
+        std::memcpy(dst, data, bytes);
+        glUnmapBuffer(target);
+    }
+
+public:
+    /** Creates the buffers. Requires a current OpenGL context. */
+    explicit MeshUploader(Strategy p_strategy = Strategy::Orphan, size_t p_segments = 3)
+        : strategy(p_strategy), segments(1) {
+        if (strategy == Strategy::MappedRing && GLAD_GL_VERSION_3_2) {
+            segments = p_segments < 2 ? 2 : (p_segments > MAX_SEGMENTS ? MAX_SEGMENTS : p_segments);
+        } else {
+            strategy = Strategy::Orphan;
+        }
+
+        glGenBuffers(1, &vbo);
+        glGenBuffers(1, &ebo);
+    }
+
+    MeshUploader(const MeshUploader&) = delete;
+    MeshUploader& operator=(const MeshUploader&) = delete;
+
+    ~MeshUploader() {
+        clear_fences();
+        glDeleteBuffers(1, &vbo);
+        glDeleteBuffers(1, &ebo);
+    }
+
+    GLuint vertex_buffer() const { return vbo; }
+    GLuint index_buffer() const { return ebo; }
+    Strategy get_strategy() const { return strategy; }
+
+    /** Capacity of a single segment of the vertex buffer, in bytes */
+    size_t vertex_buffer_capacity() const { return vertex_capacity; }
+
+    /** Capacity of a single segment of the index buffer, in bytes */
+    size_t index_buffer_capacity() const { return index_capacity; }
+
+    /** Upload raw vertex & index data. Indices may be 16 or 32 bit, as given by `index_bytes / p_index_count`.
+     * Returns false (and does nothing) if `revision` matches the last upload. Binds the uploader's vertex &
+     * index buffers, so bind the VAO that should reference them first. */
+    bool upload(
+        const void* vertices, const size_t vertex_bytes, const size_t p_vertex_stride,
+        const void* indices, const size_t index_bytes, const size_t p_index_count,
+        const uint64_t revision
+    ) {
+        if (has_uploaded && revision == uploaded_revision) {
+            return false;
+        }
+
+        has_uploaded = true;
+        uploaded_revision = revision;
+        vertex_stride = p_vertex_stride;
+        index_count = p_index_count;
+
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+
+        const size_t index_size = index_count == 0 ? sizeof(GLuint) : index_bytes / index_count;
+        index_type = index_size == sizeof(GLushort) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+        // Segments must start on a whole vertex & index, reallocate if the format changed
+        if (vertex_capacity % vertex_stride != 0) {
+            vertex_capacity = 0;
+        }
+        if (index_capacity % index_size != 0) {
+            index_capacity = 0;
+        }
+        const bool grew_vertices = reserve(GL_ARRAY_BUFFER, vertex_capacity, vertex_bytes, vertex_stride);
+        const bool grew_indices = reserve(GL_ELEMENT_ARRAY_BUFFER, index_capacity, index_bytes, index_size);
+
+        if (strategy == Strategy::Orphan) {
+            write_orphaned(GL_ARRAY_BUFFER, vertex_capacity, vertices, vertex_bytes);
+            write_orphaned(GL_ELEMENT_ARRAY_BUFFER, index_capacity, indices, index_bytes);
+            return true;
+        }
+
+        if (grew_vertices || grew_indices) {
+            // Fresh storage, nothing of it is in flight. Both buffers need it: segment 0 of the one that
+            // didn't grow may still be read by a draw the cleared fences were guarding.
+            if (!grew_vertices) {
+                glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) (vertex_capacity * segments), nullptr, GL_STREAM_DRAW);
+            }
+            if (!grew_indices) {
+                glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr) (index_capacity * segments), nullptr, GL_STREAM_DRAW);
+            }
+            clear_fences();
+            segment = 0;
+        } else {
+            segment = (segment + 1) % segments;
+            if (fences[segment] != nullptr) {
+                glClientWaitSync(fences[segment], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+                glDeleteSync(fences[segment]);
+                fences[segment] = nullptr;
+            }
+        }
+
+        write_mapped(GL_ARRAY_BUFFER, vertex_capacity, vertices, vertex_bytes);
+        write_mapped(GL_ELEMENT_ARRAY_BUFFER, index_capacity, indices, index_bytes);
+        return true;
+    }
+
+    /** Upload `mesh`. Returns false (and does nothing) if `revision` matches the last upload. */
+    bool upload(const mbl::common::graphics::MeshData& mesh, const uint64_t revision) {
+        return upload(
+            mesh.vertices.data(), mesh.vertices.size() * sizeof(mbl::common::graphics::Vertex), sizeof(mbl::common::graphics::Vertex),
+            mesh.indices.data(), mesh.indices.size() * sizeof(int32_t), mesh.indices.size(),
+            revision
+        );
+    }
+
+    /** Upload a quantized mesh, see `compact_vertex_attributes`. Returns false (and does nothing) if
+     * `revision` matches the last upload. */
+    template <typename N>
+    bool upload(const mbl::common::graphics::CompactMeshData<N>& mesh, const uint64_t revision) {
+        return upload(
+            mesh.vertices.data(), mesh.vertices.size() * sizeof(mbl::common::graphics::CompactVertex<N>), sizeof(mbl::common::graphics::CompactVertex<N>),
+            mesh.index_data(), mesh.index_count() * mesh.index_size(), mesh.index_count(),
+            revision
+        );
+    }
+
+    /** Point the bound VAO's position & normal attributes at this uploader's vertex buffer, laid out as
+     * `CompactVertex<N>`s. Shaders decode them with the `compactVertices` path of `vertex_lighting.vert`. */
+    template <typename N>
+    void compact_vertex_attributes(const GLint position_location, const GLint normal_location) const {
+        using CompactVertex = mbl::common::graphics::CompactVertex<N>;
+        const GLenum normal_type = std::is_same_v<N, int8_t> ? GL_BYTE : GL_SHORT;
+
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glVertexAttribPointer(position_location, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(CompactVertex), (void*) offsetof(CompactVertex, position));
+        glEnableVertexAttribArray(position_location);
+        glVertexAttribPointer(normal_location, 2, normal_type, GL_TRUE, sizeof(CompactVertex), (void*) offsetof(CompactVertex, normal));
+        glEnableVertexAttribArray(normal_location);
+    }
+
+    /** Byte offset of the last uploaded mesh's vertices within `vertex_buffer()` */
+    size_t vertex_offset() const {
+        return segment * vertex_capacity;
+    }
+
+    /** Byte offset of the last uploaded mesh's indices within `index_buffer()` */
+    size_t index_offset() const {
+        return segment * index_capacity;
+    }
+
+    /** Number of indices in the last uploaded mesh */
+    size_t count() const {
+        return index_count;
+    }
+
+    /** Draw the last uploaded mesh with the currently bound VAO & program. */
+    void draw(const GLenum mode = GL_TRIANGLES) {
+        if (strategy == Strategy::Orphan) {
+            glDrawElements(mode, (GLsizei) index_count, index_type, nullptr);
+            return;
+        }
+
+        const GLint base_vertex = (GLint) (vertex_offset() / vertex_stride);
+        glDrawElementsBaseVertex(mode, (GLsizei) index_count, index_type, (void*) index_offset(), base_vertex);
+
+        if (fences[segment] != nullptr) {
+            glDeleteSync(fences[segment]);
+        }
+        fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+};
\ No newline at end of file
@@ -7,6 +7,10 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
+#include <cstring>
+#include <cassert>
+#include <type_traits>
 
 #include "dependencies/glm/glm.hpp"
 #include "dependencies/glfw-3.4/deps/glad/gl.h"
@@ -38,6 +42,50 @@ struct Uniform {
     std::function<void(GLuint, GLint)> func;
 };
 
+// Typed handle to a uniform whose location was resolved once by `Shader::uniform<T>`
+template <typename T>
+struct UniformHandle {
+    size_t slot;
+};
+
+// Last value set on a uniform handle, sent to OpenGL only when it changes
+struct UniformSlot {
+    enum class Type : uint8_t { Float, Int, Vec2, Vec3, Vec4, Mat3, Mat4 };
+
+    GLint location;
+    Type type;
+    bool dirty = false;
+    bool has_value = false;
+    alignas(float) unsigned char value[sizeof(glm::mat4)] = {};
+
+    template <typename T>
+    static constexpr Type type_of() {
+        if constexpr (std::is_same_v<T, float>) { return Type::Float; }
+        else if constexpr (std::is_same_v<T, int>) { return Type::Int; }
+        else if constexpr (std::is_same_v<T, glm::vec2>) { return Type::Vec2; }
+        else if constexpr (std::is_same_v<T, glm::vec3>) { return Type::Vec3; }
+        else if constexpr (std::is_same_v<T, glm::vec4>) { return Type::Vec4; }
+        else if constexpr (std::is_same_v<T, glm::mat3>) { return Type::Mat3; }
+        else {
+            static_assert(std::is_same_v<T, glm::mat4>, "Shader.hpp: UniformHandle<T> -> T must be float, int, glm::vec2/3/4 or glm::mat3/4.");
+            return Type::Mat4;
+        }
+    }
+
+    void upload() const {
+        const float* f = reinterpret_cast<const float*>(value);
+        switch (type) {
+            case Type::Float: glUniform1fv(location, 1, f); break;
+            case Type::Int: glUniform1iv(location, 1, reinterpret_cast<const GLint*>(value)); break;
+            case Type::Vec2: glUniform2fv(location, 1, f); break;
+            case Type::Vec3: glUniform3fv(location, 1, f); break;
+            case Type::Vec4: glUniform4fv(location, 1, f); break;
+            case Type::Mat3: glUniformMatrix3fv(location, 1, GL_FALSE, f); break;
+            case Type::Mat4: glUniformMatrix4fv(location, 1, GL_FALSE, f); break;
+        }
+    }
+};
+
 // Shader abstraction to make using shaders ezpz
 class Shader {
 private:
@@ -46,6 +94,33 @@ private:
     GLuint program_id = 0;
     uniform_map umap;
 
+    std::vector<UniformSlot> slots;
+    std::vector<size_t> dirty_slots;
+
+    // asked of OpenGL rather than cached, anything may call glUseProgram behind a Shader's back
+    static GLuint current_program() {
+        GLint p_id = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &p_id);
+        return (GLuint) p_id;
+    }
+
+    // bind `p_id` & return the program it replaced
+    static GLuint bind_program(const GLuint p_id) {
+        const GLuint prev_program_id = Shader::current_program();
+        if (prev_program_id != p_id) {
+            glUseProgram(p_id);
+        }
+        return prev_program_id;
+    }
+
+    void upload_dirty_slots() {
+        for (const size_t i : this->dirty_slots) {
+            this->slots[i].upload();
+            this->slots[i].dirty = false;
+        }
+        this->dirty_slots.clear();
+    }
+
     // constants
     static constexpr int SHADER_COMPILE_FAIL = 0;
     static constexpr int PROGRAM_LINK_FAIL = 0;
@@ -135,11 +210,67 @@ public:
         return vs && fs ? s->init_program(*vs, *fs) : std::nullopt;
     }
 
+    // bind the program & send every uniform handle value that changed since the last `use`
     Shader& use() {
         glUseProgram(this->program_id);
+        this->upload_dirty_slots();
+        return *this;
+    }
+
+    // resolve the location of `uniform_name` once & return a handle to it. values set through the
+    // handle are cached, so setting an unchanged value costs no OpenGL call. asking for the same
+    // uniform again returns the same handle, which must be of the same type
+    template <typename T>
+    UniformHandle<T> uniform(const std::string& uniform_name) {
+        const GLint location = glGetUniformLocation(this->program_id, uniform_name.c_str());
+        for (size_t i = 0; i < this->slots.size(); i++) {
+            if (this->slots[i].location == location && location != -1) {
+                assert(this->slots[i].type == UniformSlot::type_of<T>() && "Shader.hpp: uniform<T> -> uniform already has a handle of another type.");
+                return UniformHandle<T> { i };
+            }
+        }
+
+        this->slots.push_back(UniformSlot { location, UniformSlot::type_of<T>() });
+        return UniformHandle<T> { this->slots.size() - 1 };
+    }
+
+    // set the value of a uniform handle. it is sent on the next `use` (or `flush_uniforms`),
+    // only if it differs from the last value set
+    template <typename T>
+    Shader& set_uniform(const UniformHandle<T> handle, const T& value) {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(UniformSlot::value));
+        UniformSlot& slot = this->slots[handle.slot];
+        assert(slot.type == UniformSlot::type_of<T>());
+        if (slot.has_value && std::memcmp(slot.value, &value, sizeof(T)) == 0) {
+            return *this;
+        }
+
+        std::memcpy(slot.value, &value, sizeof(T));
+        slot.has_value = true;
+        if (!slot.dirty && slot.location != -1) {
+            slot.dirty = true;
+            this->dirty_slots.push_back(handle.slot);
+        }
+        return *this;
+    }
+
+    // send every changed uniform handle value to OpenGL. the program bound before is bound again after
+    Shader& flush_uniforms() {
+        if (this->dirty_slots.empty()) {
+            return *this;
+        }
+
+        const GLuint prev_program_id = Shader::bind_program(this->program_id);
+        this->upload_dirty_slots();
+        Shader::bind_program(prev_program_id);
         return *this;
     }
 
+    // number of uniform handle values waiting for the next `use` or `flush_uniforms`
+    size_t pending_uniforms() const {
+        return this->dirty_slots.size();
+    }
+
     Shader& add_uniform(const std::string& uniform_name, std::function<void(GLuint program, GLint location)> F) {
         uniform_map::iterator it = this->umap.find(uniform_name);
         const GLint location = it == this->umap.end()
@@ -154,25 +285,22 @@ public:
         return *this;
     }
 
-    // call all uniform functions
+    // call all uniform functions (and send changed uniform handle values)
     Shader& ping_all_uniforms() {
-        GLint prev_program_id = 0;
-        glGetIntegerv(GL_CURRENT_PROGRAM, &prev_program_id);
-        glUseProgram(this->program_id);
+        const GLuint prev_program_id = Shader::bind_program(this->program_id);
 
-        for (std::pair<std::string, Uniform> p : this->umap) {
+        for (const std::pair<const std::string, Uniform>& p : this->umap) {
             p.second.func(this->program_id, p.second.location);
         }
+        this->upload_dirty_slots();
 
-        glUseProgram(prev_program_id);
+        Shader::bind_program(prev_program_id);
         return *this;
     }
 
     // call a specific uniform function
     Shader& ping_uniform(const std::string& uniform_name) {
-        GLint prev_program_id = 0;
-        glGetIntegerv(GL_CURRENT_PROGRAM, &prev_program_id);
-        glUseProgram(this->program_id);
+        const GLuint prev_program_id = Shader::bind_program(this->program_id);
 
         uniform_map::iterator it = this->umap.find(uniform_name);
         if (it == this->umap.end()) {
@@ -181,7 +309,7 @@ public:
             it->second.func(this->program_id, it->second.location);
         }
 
-        glUseProgram(prev_program_id);
+        Shader::bind_program(prev_program_id);
         return *this;
     }
 
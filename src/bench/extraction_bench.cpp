@@ -0,0 +1,91 @@
+#include <common/thread_pool.hpp>
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace mbl;
+using KineticEngine = MetaballEngine<Metaball<presets::KineticBlob>>;
+
+static constexpr int REPEATS = 7;
+
+/** Single digit microseconds, a thread spawn costs tens */
+static constexpr double MAX_MEDIAN_DISPATCH_US = 10.0;
+static constexpr int DISPATCH_ATTEMPTS = 3;
+
+static KineticEngine make_engine(const int32_t resolution) {
+    KineticEngine engine(glm::vec3(0.f), 10.f, resolution, 1.f);
+    engine.add_metaball(Metaball(presets::KineticBlob(glm::vec3(-2.f, 0.f, 0.f))));
+    engine.add_metaball(Metaball(presets::KineticBlob(glm::vec3(1.5f, 0.5f, 0.f))));
+    engine.add_metaball(Metaball(presets::KineticBlob(glm::vec3(0.f, -2.f, 1.f))));
+    engine.add_metaball(Metaball(presets::KineticBlob(glm::vec3(0.5f, 2.f, -1.5f))));
+    return engine;
+}
+
+/** Median milliseconds to re-extract the mesh of `engine` after an isovalue nudge (densities are reused) */
+static double extraction_ms(KineticEngine& engine) {
+    engine.construct_mesh();
+    std::vector<double> times;
+    for (int i = 0; i < REPEATS; i++) {
+        engine.set_isovalue(1.f + 0.001f * (float) (i % 2));
+        const auto start = std::chrono::steady_clock::now();
+        engine.construct_mesh();
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+/** Median microseconds to hand a two chunk parallel_for to a pool of `workers` workers */
+static double dispatch_us(const uint32_t workers) {
+    common::ThreadPool pool(workers);
+    std::atomic<int64_t> sink = 0;
+    std::vector<double> times;
+    for (int i = 0; i < 1000; i++) {
+        const auto start = std::chrono::steady_clock::now();
+        pool.parallel_for(0, 2, [&sink](const int64_t low, const int64_t) { sink.fetch_add(low); });
+        times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+int main() {
+    const uint32_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::cout << "resolution | backend | ms | vertices | triangles" << std::endl;
+    for (const int32_t resolution : { 64, 128, 256 }) {
+        struct Run { const char* name; ExtractionBackend backend; uint32_t workers; };
+        const Run runs[] = {
+            { "marching cubes", ExtractionBackend::MarchingCubes, 1 },
+            { "flying edges (1 thread)", ExtractionBackend::FlyingEdges, 1 },
+            { "flying edges (all threads)", ExtractionBackend::FlyingEdges, threads },
+            { "surface nets", ExtractionBackend::SurfaceNets, 1 }
+        };
+
+        for (const Run& run : runs) {
+            KineticEngine engine = make_engine(resolution);
+            engine.set_extraction_backend(run.backend, run.workers);
+            const double ms = extraction_ms(engine);
+            const common::graphics::MeshData& mesh = engine.construct_mesh();
+            std::cout << resolution << " | " << run.name << " | " << ms << " | " << mesh.vertices.size() << " | " << mesh.indices.size() / 3 << std::endl;
+        }
+    }
+
+    // Fewer workers than cores, so the pool isn't fighting this thread. A busy machine gets a few tries
+    const uint32_t workers = std::max(threads, 2u) - 1;
+    double median = 0.0;
+    for (int attempt = 0; attempt < DISPATCH_ATTEMPTS && (attempt == 0 || median >= MAX_MEDIAN_DISPATCH_US); attempt++) {
+        median = dispatch_us(workers);
+        std::cout << "thread pool dispatch (" << workers << " workers) | median " << median << " us" << std::endl;
+    }
+    if (median >= MAX_MEDIAN_DISPATCH_US) {
+        std::cout << "dispatch is over " << MAX_MEDIAN_DISPATCH_US << " us" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
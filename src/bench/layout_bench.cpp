@@ -0,0 +1,158 @@
+#include <isosurface.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace mbl;
+
+static constexpr int REPEATS = 5;
+static constexpr float ISOVALUE = 0.f;
+
+/** Set associative LRU cache of 64 byte lines, counting the misses of the addresses fed to it */
+class CacheModel {
+    private:
+        std::vector<uint64_t> tags;     // per set, most recently used first
+        size_t sets;
+        size_t ways;
+
+    public:
+        size_t misses = 0;
+
+        CacheModel(const size_t bytes, const size_t p_ways) : tags(bytes / 64, ~uint64_t(0)), sets(bytes / 64 / p_ways), ways(p_ways) {}
+
+        void access(const uint64_t address) {
+            const uint64_t line = address / 64;
+            uint64_t* set = tags.data() + (line % sets) * ways;
+            size_t way = 0;
+            while (way < ways && set[way] != line) {
+                way += 1;
+            }
+
+            misses += (size_t) (way == ways);
+            std::copy_backward(set, set + std::min(way, ways - 1), set + std::min(way + 1, ways));
+            set[0] = line;
+        }
+};
+
+/** Calls `f(x, y, z)` for every cell of a field with `cells` cells per axis, either row by row or
+ * brick by brick (x fastest within each) */
+template <typename F>
+static void for_each_cell(const IndexDim& cells, const bool by_brick, F&& f) {
+    if (!by_brick) {
+        for (int32_t z = 0; z < cells.z; z++) {
+            for (int32_t y = 0; y < cells.y; y++) {
+                for (int32_t x = 0; x < cells.x; x++) {
+                    f(x, y, z);
+                }
+            }
+        }
+        return;
+    }
+
+    const int32_t side = 1 << IndexCompactor::BRICK_SHIFT;
+    for (int32_t bz = 0; bz < cells.z; bz += side) {
+        for (int32_t by = 0; by < cells.y; by += side) {
+            for (int32_t bx = 0; bx < cells.x; bx += side) {
+                for (int32_t z = bz; z < std::min(bz + side, cells.z); z++) {
+                    for (int32_t y = by; y < std::min(by + side, cells.y); y++) {
+                        for (int32_t x = bx; x < std::min(bx + side, cells.x); x++) {
+                            f(x, y, z);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+/** Gathers the 8 corner densities of every cell of `field` into case bytes, in row or brick order,
+ * calling `visit(node)` on every corner read & returning how many cells the surface crosses.
+ * Flattened indices come from per axis tables, so both layouts cost the same arithmetic & only
+ * differ in where the corners sit in memory. */
+struct Gather {
+    std::vector<int32_t> axis_offsets[3];
+
+    explicit Gather(const IsoSurface& field) {
+        const IndexCompactor compactor = field.compactor();
+        for (int32_t axis = 0; axis < 3; axis++) {
+            for (int32_t i = 0; i < field.shape()[axis]; i++) {
+                axis_offsets[axis].push_back(compactor.flatten_at(i, axis));
+            }
+        }
+    }
+
+    template <typename Visit>
+    size_t run(const IsoSurface& field, const bool by_brick, Visit&& visit) const {
+        const IsoPoint* nodes = field.data();
+        size_t crossed = 0;
+        for_each_cell(field.shape() - 1, by_brick, [&](const int32_t x, const int32_t y, const int32_t z) {
+            const int32_t xs[2] = { axis_offsets[0][x], axis_offsets[0][x + 1] };
+            const int32_t ys[2] = { axis_offsets[1][y], axis_offsets[1][y + 1] };
+            const int32_t zs[2] = { axis_offsets[2][z], axis_offsets[2][z + 1] };
+            uint8_t cube_bits = 0;
+            for (int32_t c = 0; c < 8; c++) {
+                const int32_t node = xs[c & 1] + ys[(c >> 1) & 1] + zs[c >> 2];
+                visit(node);
+                cube_bits |= (uint8_t) (nodes[node].density >= ISOVALUE) << c;
+            }
+            crossed += (size_t) (cube_bits != 0x0 && cube_bits != 0xFF);
+        });
+        return crossed;
+    }
+};
+
+static IsoSurface make_field(const int32_t resolution, const NodeLayout layout) {
+    IsoSurface field = IsoSurface::construct(glm::vec3(0.f), glm::vec3(5.f), IndexDim(resolution), layout);
+    for (IsoPoint& point : field.isopoints()) {
+        point.density = std::sin(point.position.x) * std::cos(point.position.y) + std::sin(point.position.z);
+    }
+    return field;
+}
+
+int main(int argc, char** argv) {
+    std::vector<int32_t> resolutions = { 128, 256 };
+    if (argc > 1) {
+        resolutions = { std::atoi(argv[1]) };
+    }
+
+    std::cout << "resolution | layout | traversal | ms | L1 misses / cell | L2 misses / cell" << std::endl;
+    for (const int32_t resolution : resolutions) {
+        for (const NodeLayout layout : { NodeLayout::Linear, NodeLayout::Bricked }) {
+            const IsoSurface field = make_field(resolution, layout);
+            const Gather gather(field);
+            const double cells = std::pow((double) resolution, 3.0);
+
+            for (const bool by_brick : { false, true }) {
+                std::vector<double> times;
+                size_t cases = 0;
+                for (int i = 0; i < REPEATS; i++) {
+                    const auto start = std::chrono::steady_clock::now();
+                    cases = gather.run(field, by_brick, [](const int32_t) {});
+                    times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+                }
+                std::sort(times.begin(), times.end());
+
+                // 32 KiB 8 way L1 & 1 MiB 16 way L2, fed the density of every corner read
+                CacheModel l1(32 << 10, 8);
+                CacheModel l2(1 << 20, 16);
+                gather.run(field, by_brick, [&](const int32_t node) {
+                    const uint64_t address = (uint64_t) node * sizeof(IsoPoint) + offsetof(IsoPoint, density);
+                    l1.access(address);
+                    l2.access(address);
+                });
+
+                std::cout << resolution << " | " << (layout == NodeLayout::Linear ? "linear" : "bricked")
+                    << " | " << (by_brick ? "bricks" : "rows") << " | " << times[times.size() / 2]
+                    << " | " << (double) l1.misses / cells << " | " << (double) l2.misses / cells
+                    << (cases == 0 ? " (no surface)" : "") << std::endl;
+            }
+        }
+    }
+    return 0;
+}
\ No newline at end of file
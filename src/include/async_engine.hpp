@@ -0,0 +1,227 @@
+#pragma once
+
+// MBL
+#include <engine.hpp>
+#include <common/graphics.hpp>
+
+// STD
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mbl {
+    /** Number of mesh buffers cycled between an AsyncMetaballEngine's worker & its consumer.
+     *
+     * Double: the worker builds into the one buffer the consumer isn't holding, then waits for the
+     *  consumer to pick it up before starting the next build. Uses the least memory, but the consumer
+     *  must keep calling `acquire_latest` for builds to progress (don't block on a `request_mesh`
+     *  future without acquiring).
+     *
+     * Triple: the worker always has a free buffer to build into, the consumer always gets the newest
+     *  finished mesh. Neither side ever waits on the other. */
+    enum class BufferingPolicy : uint32_t {
+        Double = 2,
+        Triple = 3
+    };
+
+    /** A finished mesh handed out by `AsyncMetaballEngine::acquire_latest`. */
+    struct MeshFrame {
+        uint64_t generation;    // Which build produced this mesh, 0 if no mesh has been built yet
+        const common::graphics::MeshData* mesh;
+    };
+
+    /** Wrapper that owns a MetaballEngine & builds its meshes on a worker thread. While the caller
+     * consumes mesh N, mesh N+1 is built in the background. Finished meshes are handed from the
+     * worker to the caller through a single atomic exchange, so `acquire_latest` never blocks.
+     *
+     * Metaball updates must be made through `request_mesh` so they run on the worker, in order,
+     * right before the build that includes them. Requests that arrive while a build is running
+     * are coalesced into the next build, so the worker is never more than one build behind.
+     *
+     * @code
+     * mbl::AsyncMetaballEngine<M> async(std::move(engine));
+     * while (running) {
+     *     async.request_mesh([dt](mbl::MetaballEngine<M>& e) { ...update metaballs... });
+     *     mbl::MeshFrame frame = async.acquire_latest();
+     *     if (frame.generation != last_generation) { ...upload frame.mesh... }
+     * }
+     * @endcode
+     * */
+    template <typename M = AggregateMetaball>
+    class AsyncMetaballEngine {
+        public:
+            using Update = std::function<void(MetaballEngine<M>&)>;
+
+        private:
+            static constexpr uint32_t FRESH = 0x4;         // set on `ready` when it holds an unconsumed mesh
+            static constexpr uint32_t SLOT_MASK = 0x3;
+            static constexpr uint32_t NO_SLOT = 0x3;        // `ready` holds no buffer (double buffering start)
+            static constexpr uint32_t STOPPED = 0x8;        // set on `ready` when the engine is being destroyed
+
+            struct Request {
+                Update update;
+                std::promise<uint64_t> done;
+            };
+
+            MetaballEngine<M> engine;
+            const BufferingPolicy policy;
+
+            std::array<common::graphics::MeshData, 3> slots;
+            std::array<uint64_t, 3> slot_generations = {};
+            std::atomic<uint32_t> ready;
+            uint32_t front = 0;     // owned by the consumer
+            uint32_t back;          // owned by the worker
+            uint32_t published_slot = 0;
+
+            std::mutex request_mutex;
+            std::condition_variable request_cv;
+            std::vector<Request> pending;
+            std::vector<Request> in_flight;
+            bool stopping = false;
+
+            uint64_t generation = 0;
+            std::thread worker;
+
+            void run() {
+                while (true) {
+                    {
+                        std::unique_lock<std::mutex> lock(request_mutex);
+                        request_cv.wait(lock, [this] { return stopping || !pending.empty(); });
+                        if (stopping) {
+                            break;
+                        }
+                        std::swap(pending, in_flight);
+                    }
+
+                    for (Request& request : in_flight) {
+                        if (request.update) {
+                            request.update(engine);
+                        }
+                    }
+
+                    slots[back] = engine.construct_mesh();
+                    generation += 1;
+                    slot_generations[back] = generation;
+
+                    const bool published = publish();
+                    for (Request& request : in_flight) {
+                        request.done.set_value(published ? generation : 0);
+                    }
+                    in_flight.clear();
+
+                    if (!published || !reclaim()) {
+                        break;
+                    }
+                }
+            }
+
+            /** Hand the back buffer to the consumer. Returns false if the engine is being destroyed. */
+            bool publish() {
+                if (policy == BufferingPolicy::Triple) {
+                    published_slot = ready.exchange(back | FRESH, std::memory_order_acq_rel);
+                    return true;
+                }
+
+                uint32_t current = ready.load(std::memory_order_acquire);
+                do {
+                    if ((current & STOPPED) != 0) {
+                        return false;
+                    }
+                } while (!ready.compare_exchange_weak(current, back | FRESH, std::memory_order_acq_rel));
+                return true;
+            }
+
+            /** Take a free buffer to build the next mesh into. Returns false if the engine was destroyed
+             * while waiting. */
+            bool reclaim() {
+                if (policy == BufferingPolicy::Triple) {
+                    back = published_slot & SLOT_MASK;
+                    return true;
+                }
+
+                // Double buffering: the only free buffer is the one the consumer holds, wait for it
+                const uint32_t published = back | FRESH;
+                uint32_t current = published;
+                while (current == published) {
+                    ready.wait(published, std::memory_order_acquire);
+                    current = ready.load(std::memory_order_acquire);
+                }
+
+                if ((current & STOPPED) != 0) {
+                    return false;
+                }
+
+                back = current & SLOT_MASK;
+                return true;
+            }
+
+        public:
+            explicit AsyncMetaballEngine(MetaballEngine<M>&& p_engine, const BufferingPolicy p_policy = BufferingPolicy::Triple)
+                : engine(std::move(p_engine)),
+                  policy(p_policy),
+                  ready(p_policy == BufferingPolicy::Triple ? 1 : NO_SLOT),
+                  back(p_policy == BufferingPolicy::Triple ? 2 : 1),
+                  worker() {
+                worker = std::thread(&AsyncMetaballEngine<M>::run, this);
+            }
+
+            AsyncMetaballEngine(const AsyncMetaballEngine&) = delete;
+            AsyncMetaballEngine& operator=(const AsyncMetaballEngine&) = delete;
+
+            ~AsyncMetaballEngine() {
+                {
+                    std::lock_guard<std::mutex> lock(request_mutex);
+                    stopping = true;
+                }
+                request_cv.notify_one();
+
+                // Wake the worker if it is waiting for the consumer in double buffering
+                ready.fetch_or(STOPPED, std::memory_order_acq_rel);
+                ready.notify_one();
+                worker.join();
+
+                for (Request& request : pending) {
+                    request.done.set_value(0);
+                }
+            }
+
+            /** Queue `update` to be run against the engine on the worker thread, followed by a mesh build.
+             * Never waits on extraction. The returned future resolves to the generation of the first mesh
+             * that includes this update (or 0 if the engine is destroyed first). */
+            std::future<uint64_t> request_mesh(Update update = {}) {
+                Request request { std::move(update), std::promise<uint64_t>() };
+                std::future<uint64_t> result = request.done.get_future();
+                {
+                    std::lock_guard<std::mutex> lock(request_mutex);
+                    pending.push_back(std::move(request));
+                }
+                request_cv.notify_one();
+                return result;
+            }
+
+            /** Returns the newest finished mesh without blocking. The mesh stays valid until the next
+             * `acquire_latest` call. If no new mesh was finished since the last call, the same mesh is returned. */
+            MeshFrame acquire_latest() {
+                if ((ready.load(std::memory_order_acquire) & FRESH) != 0) {
+                    front = ready.exchange(front, std::memory_order_acq_rel) & SLOT_MASK;
+                    if (policy == BufferingPolicy::Double) {
+                        ready.notify_one();
+                    }
+                }
+
+                return MeshFrame {
+                    slot_generations[front],
+                    &slots[front]
+                };
+            }
+
+            BufferingPolicy buffering() const {
+                return policy;
+            }
+    };
+}
\ No newline at end of file
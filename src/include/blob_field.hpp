@@ -0,0 +1,151 @@
+#pragma once
+
+#include "../dependencies/glm/glm.hpp"
+
+#include <metaball.hpp>
+#include <vector>
+#include <cassert>
+
+namespace mbl {
+    namespace presets {
+        /**
+         * A collection of `InverseSquareBlob`s stored as a structure of arrays (the x, y, z
+         * coordinates of each center & each scale live in their own parallel arrays). The
+         * whole collection is a single Metaball, meaning it can be passed to a `MetaballEngine`
+         * as its `M`, and every blob is summed in one tight loop per query point.
+         *
+         * @code
+         * mbl::MetaballEngine<mbl::presets::BlobField> engine(...);
+         * mbl::presets::BlobField field;
+         * for (const glm::vec3& p : particles) { field.add_blob(p, 0.01f); }
+         * engine.add_metaball(std::move(field));
+         * @endcode
+         * */
+        class BlobField : public MetaballExpression<BlobField> {
+        private:
+            /** Number of independent accumulators used when summing over blobs. Splitting the
+             * sum across lanes lets the compiler vectorize without reassociating a single float sum. */
+            static constexpr size_t LANES = 8;
+
+            std::vector<float> m_xs;
+            std::vector<float> m_ys;
+            std::vector<float> m_zs;
+            std::vector<float> m_scales;
+
+            static float blob(float cx, float cy, float cz, float s, float x, float y, float z) {
+                const float dx = cx - x;
+                const float dy = cy - y;
+                const float dz = cz - z;
+                return s / (dx * dx + dy * dy + dz * dz);
+            }
+
+        public:
+            BlobField() = default;
+
+            /** Add a blob centered on `center` with scale `scale`. The index of the blob is returned. */
+            size_t add_blob(const glm::vec3& center, const float scale = 1.0f) {
+                const size_t index = m_xs.size();
+                m_xs.push_back(center.x);
+                m_ys.push_back(center.y);
+                m_zs.push_back(center.z);
+                m_scales.push_back(scale);
+                return index;
+            }
+
+            void reserve(const size_t n) {
+                m_xs.reserve(n);
+                m_ys.reserve(n);
+                m_zs.reserve(n);
+                m_scales.reserve(n);
+            }
+
+            void clear() {
+                m_xs.clear();
+                m_ys.clear();
+                m_zs.clear();
+                m_scales.clear();
+            }
+
+            /** Returns the number of blobs in this field */
+            size_t size() const { return m_xs.size(); }
+
+            glm::vec3 get_center(const size_t i) const {
+                return glm::vec3(m_xs[i], m_ys[i], m_zs[i]);
+            }
+
+            void set_center(const size_t i, const glm::vec3& center) {
+                m_xs[i] = center.x;
+                m_ys[i] = center.y;
+                m_zs[i] = center.z;
+            }
+
+            float get_scale(const size_t i) const { return m_scales[i]; }
+            void set_scale(const size_t i, const float scale) { m_scales[i] = scale; }
+
+            /** Direct access to the underlying arrays, for bulk updates (e.g. particle systems). */
+            float* xs() { return m_xs.data(); }
+            float* ys() { return m_ys.data(); }
+            float* zs() { return m_zs.data(); }
+            float* scales() { return m_scales.data(); }
+            const float* xs() const { return m_xs.data(); }
+            const float* ys() const { return m_ys.data(); }
+            const float* zs() const { return m_zs.data(); }
+            const float* scales() const { return m_scales.data(); }
+
+            float operator()(float x, float y, float z) const {
+                const size_t n = size();
+                const float* cx = m_xs.data();
+                const float* cy = m_ys.data();
+                const float* cz = m_zs.data();
+                const float* s = m_scales.data();
+
+                float acc[LANES] = {};
+                size_t i = 0;
+                for (; i + LANES <= n; i += LANES) {
+                    for (size_t l = 0; l < LANES; l++) {
+                        acc[l] += blob(cx[i + l], cy[i + l], cz[i + l], s[i + l], x, y, z);
+                    }
+                }
+
+                for (; i < n; i++) {
+                    acc[0] += blob(cx[i], cy[i], cz[i], s[i], x, y, z);
+                }
+
+                float sum = 0.f;
+                for (size_t l = 0; l < LANES; l++) {
+                    sum += acc[l];
+                }
+                return sum;
+            }
+
+            /** Adds the field's value at each of the `n` points (xs[j], ys[j], zs[j]) onto out[j].
+             * Blobs are walked in the outer loop so each blob's parameters are loaded once per batch,
+             * while the inner loop over points is contiguous & branch free. */
+            void compute_batch(const float* xs, const float* ys, const float* zs, float* out, size_t n) const {
+                const size_t num_blobs = size();
+                for (size_t b = 0; b < num_blobs; b++) {
+                    const float cx = m_xs[b];
+                    const float cy = m_ys[b];
+                    const float cz = m_zs[b];
+                    const float s = m_scales[b];
+                    for (size_t j = 0; j < n; j++) {
+                        out[j] += blob(cx, cy, cz, s, xs[j], ys[j], zs[j]);
+                    }
+                }
+            }
+
+            /** Joined bounding box of every blob. Like `InverseSquareBlob`, each blob's box is the
+             * heuristic sqrt(scale) around its center. */
+            BoundingBox get_bounding_box() const {
+                assert(size() > 0);
+                BoundingBox box { get_center(0), get_center(0) };
+                for (size_t i = 0; i < size(); i++) {
+                    const glm::vec3 center = get_center(i);
+                    const glm::vec3 sqrt_of_scale_vec(sqrtf(m_scales[i]));
+                    box.join_mut(BoundingBox{ center + sqrt_of_scale_vec, center - sqrt_of_scale_vec });
+                }
+                return box;
+            }
+        };
+    }
+}
\ No newline at end of file
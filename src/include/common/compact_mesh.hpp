@@ -0,0 +1,153 @@
+#pragma once
+
+#include "../../dependencies/glm/glm.hpp"
+#include "graphics.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace mbl {
+    namespace common {
+        namespace graphics {
+            /** Quantized vertex. `position` is 16-bit fixed point relative to the bounds of the mesh it
+             * belongs to, `normal` is an octahedron-encoded unit vector with `N` (int8_t or int16_t)
+             * per component. 8 bytes with 8-bit normals, 10 bytes with 16-bit normals. */
+            template <typename N>
+            struct CompactVertex {
+                static_assert(std::is_same_v<N, int8_t> || std::is_same_v<N, int16_t>, "compact_mesh.hpp: CompactVertex<N> -> N must be int8_t or int16_t.");
+
+                uint16_t position[3];
+                N normal[2];
+            };
+
+            using CompactVertex8 = CompactVertex<int8_t>;
+            using CompactVertex16 = CompactVertex<int16_t>;
+
+            /** Compact counterpart of `MeshData`. Indices are 16-bit whenever the mesh has fewer than
+             * 65536 vertices, 32-bit otherwise; only one of `short_indices` & `long_indices` is filled.
+             *
+             * To decode a position: `bounds_min + (position / 65535.0) * bounds_size`. */
+            template <typename N>
+            struct CompactMeshData {
+                std::vector<CompactVertex<N>> vertices;
+                std::vector<uint16_t> short_indices;
+                std::vector<uint32_t> long_indices;
+                glm::vec3 bounds_min = glm::vec3(0.f);
+                glm::vec3 bounds_size = glm::vec3(1.f);
+                uint64_t revision = 0;      // Revision of the mesh this was encoded from, 0 if never encoded
+
+                bool uses_short_indices() const {
+                    return long_indices.empty();
+                }
+
+                size_t index_count() const {
+                    return uses_short_indices() ? short_indices.size() : long_indices.size();
+                }
+
+                /** Size of a single index in bytes (2 or 4) */
+                size_t index_size() const {
+                    return uses_short_indices() ? sizeof(uint16_t) : sizeof(uint32_t);
+                }
+
+                const void* index_data() const {
+                    return uses_short_indices() ? (const void*) short_indices.data() : (const void*) long_indices.data();
+                }
+
+                /** Total bytes of vertex & index data */
+                size_t byte_size() const {
+                    return vertices.size() * sizeof(CompactVertex<N>) + index_count() * index_size();
+                }
+            };
+
+            /** Map `t` in [0, 1] to the full range of a 16 bit unsigned integer */
+            inline uint16_t quantize_unorm16(const float t) {
+                const float clamped = std::fmin(std::fmax(t, 0.f), 1.f);
+                return (uint16_t) std::lround(clamped * 65535.f);
+            }
+
+            /** Map `t` in [-1, 1] to the full range of the signed integer `N`, matching OpenGL's
+             * normalized signed integer conversion. */
+            template <typename N>
+            N quantize_snorm(const float t) {
+                constexpr float max_value = (float) std::numeric_limits<N>::max();
+                const float clamped = std::fmin(std::fmax(t, -1.f), 1.f);
+                return (N) std::lround(clamped * max_value);
+            }
+
+            /** Project the unit vector `n` onto the octahedron & unfold it onto the [-1, 1] square */
+            inline glm::vec2 octahedron_encode(const glm::vec3& n) {
+                const float l1 = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+                if (l1 == 0.f) {
+                    return glm::vec2(0.f);
+                }
+
+                glm::vec2 p = glm::vec2(n.x, n.y) / l1;
+                if (n.z < 0.f) {
+                    p = glm::vec2(
+                        (1.f - std::fabs(p.y)) * (p.x >= 0.f ? 1.f : -1.f),
+                        (1.f - std::fabs(p.x)) * (p.y >= 0.f ? 1.f : -1.f)
+                    );
+                }
+                return p;
+            }
+
+            /** Inverse of `octahedron_encode`, mirrored in `vertex_lighting.vert` */
+            inline glm::vec3 octahedron_decode(const glm::vec2& e) {
+                glm::vec3 n = glm::vec3(e.x, e.y, 1.f - std::fabs(e.x) - std::fabs(e.y));
+                const float t = std::fmax(-n.z, 0.f);
+                n.x += n.x >= 0.f ? -t : t;
+                n.y += n.y >= 0.f ? -t : t;
+                return glm::normalize(n);
+            }
+
+            /** Quantize `mesh` into `out`, with positions relative to the box starting at `bounds_min`
+             * with side lengths `bounds_size`. `out`'s buffers are reused. */
+            template <typename N>
+            void encode_compact_mesh(const MeshData& mesh, const glm::vec3& bounds_min, const glm::vec3& bounds_size, CompactMeshData<N>& out) {
+                out.bounds_min = bounds_min;
+                out.bounds_size = bounds_size;
+
+                const glm::vec3 inverse_size = glm::vec3(1.f) / glm::max(bounds_size, glm::vec3(std::numeric_limits<float>::min()));
+                out.vertices.resize(mesh.vertices.size());
+                for (size_t i = 0; i < mesh.vertices.size(); i++) {
+                    const Vertex& v = mesh.vertices[i];
+                    const glm::vec3 t = (v.position - bounds_min) * inverse_size;
+                    const glm::vec2 oct = octahedron_encode(v.normal);
+
+                    CompactVertex<N>& cv = out.vertices[i];
+                    cv.position[0] = quantize_unorm16(t.x);
+                    cv.position[1] = quantize_unorm16(t.y);
+                    cv.position[2] = quantize_unorm16(t.z);
+                    cv.normal[0] = quantize_snorm<N>(oct.x);
+                    cv.normal[1] = quantize_snorm<N>(oct.y);
+                }
+
+                out.short_indices.clear();
+                out.long_indices.clear();
+                if (mesh.vertices.size() <= (size_t) std::numeric_limits<uint16_t>::max() + 1) {
+                    out.short_indices.assign(mesh.indices.begin(), mesh.indices.end());
+                } else {
+                    out.long_indices.assign(mesh.indices.begin(), mesh.indices.end());
+                }
+            }
+
+            /** Decode the position of vertex `v` of `mesh` */
+            template <typename N>
+            glm::vec3 decode_position(const CompactMeshData<N>& mesh, const CompactVertex<N>& v) {
+                const glm::vec3 t = glm::vec3(v.position[0], v.position[1], v.position[2]) / 65535.f;
+                return mesh.bounds_min + t * mesh.bounds_size;
+            }
+
+            /** Decode the normal of vertex `v` */
+            template <typename N>
+            glm::vec3 decode_normal(const CompactVertex<N>& v) {
+                constexpr float max_value = (float) std::numeric_limits<N>::max();
+                const glm::vec2 e = glm::vec2(v.normal[0], v.normal[1]) / max_value;
+                return octahedron_decode(glm::max(e, glm::vec2(-1.f)));
+            }
+        }
+    }
+}
\ No newline at end of file
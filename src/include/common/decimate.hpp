@@ -0,0 +1,521 @@
+#pragma once
+
+#include "../../dependencies/glm/glm.hpp"
+#include "graphics.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mbl {
+    namespace common {
+        namespace graphics {
+            /** When `MeshDecimator` stops collapsing edges. Whichever limit is hit first wins. */
+            struct DecimationOptions {
+                size_t target_triangles = 0;                                // stop at this many triangles, 0 for no count target
+                float max_error = std::numeric_limits<float>::infinity();   // never move the surface further than about this far
+                int32_t chunks = 4;                                         // spatial chunks per axis, worked on independently
+                uint32_t workers = 1;                                       // threads of the shared pool working on chunks, 1 for none
+            };
+
+            /** Quadric error metric edge collapse (Garland & Heckbert, 1997) over a `MeshData`.
+             *
+             * Vertices sharing a position are welded first, so the per-triangle vertices of the engine's
+             * marching cubes decimate the same as an indexed mesh. Each vertex carries the quadric of the
+             * planes of its original triangles, & the cheapest edges (by squared distance to those planes)
+             * are collapsed first into their quadric-optimal point. Collapses that would flip a triangle or
+             * pinch the surface into a non-manifold are skipped. Open boundaries (where the field cuts the
+             * surface) are never moved.
+             *
+             * The mesh's bounding box is split into `chunks`^3 chunks decimated in parallel. A vertex with a
+             * triangle reaching into another chunk is locked, so every collapse only touches triangles
+             * owned by one chunk. A second round over a grid offset by half a chunk frees the first
+             * round's borders. Buffers are kept between calls. */
+            class MeshDecimator {
+                private:
+                    /** Symmetric 4x4 matrix, upper triangle row by row */
+                    struct Quadric {
+                        double q[10] = {};
+
+                        static Quadric plane(const glm::dvec3& n, const double d) {
+                            Quadric p;
+                            p.q[0] = n.x * n.x; p.q[1] = n.x * n.y; p.q[2] = n.x * n.z; p.q[3] = n.x * d;
+                            p.q[4] = n.y * n.y; p.q[5] = n.y * n.z; p.q[6] = n.y * d;
+                            p.q[7] = n.z * n.z; p.q[8] = n.z * d;
+                            p.q[9] = d * d;
+                            return p;
+                        }
+
+                        Quadric& operator+=(const Quadric& other) {
+                            for (int i = 0; i < 10; i++) {
+                                q[i] += other.q[i];
+                            }
+                            return *this;
+                        }
+
+                        double error(const glm::dvec3& v) const {
+                            return q[0] * v.x * v.x + 2.0 * q[1] * v.x * v.y + 2.0 * q[2] * v.x * v.z + 2.0 * q[3] * v.x
+                                + q[4] * v.y * v.y + 2.0 * q[5] * v.y * v.z + 2.0 * q[6] * v.y
+                                + q[7] * v.z * v.z + 2.0 * q[8] * v.z
+                                + q[9];
+                        }
+
+                        /** Point of least error, false if the quadric is (near) singular */
+                        bool minimum(glm::dvec3& out) const {
+                            const glm::dmat3 a = glm::dmat3(
+                                q[0], q[1], q[2],
+                                q[1], q[4], q[5],
+                                q[2], q[5], q[7]
+                            );
+                            const double det = glm::determinant(a);
+                            if (std::fabs(det) < 1e-12) {
+                                return false;
+                            }
+                            out = glm::inverse(a) * -glm::dvec3(q[3], q[6], q[8]);
+                            return true;
+                        }
+                    };
+
+                    struct Collapse {
+                        double cost;
+                        int32_t a;
+                        int32_t b;
+                        uint32_t version_a;
+                        uint32_t version_b;
+                        glm::vec3 position;
+
+                        bool operator>(const Collapse& other) const {
+                            return cost > other.cost;
+                        }
+                    };
+
+                    std::vector<Vertex> vertices;
+                    std::vector<int32_t> indices;
+                    std::vector<Quadric> quadrics;
+                    std::vector<std::vector<int32_t>> vertex_triangles;
+                    std::vector<uint32_t> versions;         // bumped whenever a vertex moves or dies
+                    std::vector<uint8_t> vertex_dead;
+                    std::vector<uint8_t> triangle_dead;
+                    std::vector<uint8_t> on_boundary;       // on an open or non-manifold edge, never moved
+                    std::vector<int32_t> vertex_chunk;      // chunk of each vertex in the current round, -1 if locked
+                    std::vector<std::vector<int32_t>> chunk_triangles;
+
+                    static bool finite(const glm::vec3& p) {
+                        return std::isfinite(p.x) && std::isfinite(p.y) && std::isfinite(p.z);
+                    }
+
+                    /** Merges vertices within a millionth of the mesh's size of each other into `vertices` &
+                     * `indices`, dropping triangles left with a repeated vertex. Marching cubes interpolates a
+                     * shared edge from either end depending on the cell, so copies aren't always bitwise equal.
+                     * Triangles with a non-finite corner (a field blowing up at a node) are dropped too, they'd
+                     * make the bounds & weld keys meaningless. */
+                    void weld(const MeshData& mesh) {
+                        struct KeyHash {
+                            size_t operator()(const glm::ivec3& k) const {
+                                return (size_t) ((uint32_t) k.x * 73856093u ^ (uint32_t) k.y * 19349663u ^ (uint32_t) k.z * 83492791u);
+                            }
+                        };
+
+                        glm::vec3 low = glm::vec3(std::numeric_limits<float>::max());
+                        glm::vec3 high = glm::vec3(std::numeric_limits<float>::lowest());
+                        for (const Vertex& v : mesh.vertices) {
+                            if (finite(v.position)) {
+                                low = glm::min(low, v.position);
+                                high = glm::max(high, v.position);
+                            }
+                        }
+                        const glm::vec3 extent = glm::max(high - low, glm::vec3(0.f));
+                        const float step = std::fmax(std::fmax(extent.x, extent.y), std::fmax(extent.z, std::numeric_limits<float>::min())) * 1e-6f;
+
+                        std::unordered_map<glm::ivec3, int32_t, KeyHash> welded;
+                        welded.reserve(mesh.vertices.size());
+                        std::vector<int32_t> remap(mesh.vertices.size(), -1);
+                        vertices.clear();
+                        for (size_t i = 0; i < mesh.vertices.size(); i++) {
+                            if (!finite(mesh.vertices[i].position)) {
+                                continue;
+                            }
+                            const glm::vec3 t = (mesh.vertices[i].position - low) / step;
+                            const glm::ivec3 key = glm::ivec3(glm::round(t));
+
+                            // Copies can round to neighbouring keys, check those before adding a vertex
+                            auto found = welded.find(key);
+                            for (int32_t n = 0; n < 27 && found == welded.end(); n++) {
+                                const glm::ivec3 neighbour = key + glm::ivec3(n % 3 - 1, (n / 3) % 3 - 1, n / 9 - 1);
+                                found = glm::all(glm::lessThanEqual(glm::abs(t - glm::vec3(neighbour)), glm::vec3(1.f))) ? welded.find(neighbour) : welded.end();
+                            }
+                            if (found == welded.end()) {
+                                found = welded.emplace(key, (int32_t) vertices.size()).first;
+                                vertices.push_back(mesh.vertices[i]);
+                            }
+                            remap[i] = found->second;
+                        }
+
+                        indices.clear();
+                        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+                            const int32_t a = remap[mesh.indices[i]];
+                            const int32_t b = remap[mesh.indices[i + 1]];
+                            const int32_t c = remap[mesh.indices[i + 2]];
+                            if (a >= 0 && b >= 0 && c >= 0 && a != b && b != c && a != c) {
+                                indices.insert(indices.end(), { a, b, c });
+                            }
+                        }
+                    }
+
+                    /** Quadrics, adjacency & boundary flags of the welded mesh */
+                    void prepare() {
+                        const size_t vertex_count = vertices.size();
+                        const size_t triangle_count = indices.size() / 3;
+                        quadrics.assign(vertex_count, Quadric());
+                        vertex_triangles.resize(vertex_count);
+                        for (std::vector<int32_t>& list : vertex_triangles) {
+                            list.clear();
+                        }
+                        versions.assign(vertex_count, 0);
+                        vertex_dead.assign(vertex_count, 0);
+                        triangle_dead.assign(triangle_count, 0);
+                        on_boundary.assign(vertex_count, 0);
+
+                        std::vector<std::pair<int32_t, int32_t>> edges;
+                        edges.reserve(indices.size());
+                        for (size_t t = 0; t < triangle_count; t++) {
+                            const int32_t* tri = &indices[3 * t];
+                            const glm::dvec3 p0 = vertices[tri[0]].position;
+                            const glm::dvec3 normal = glm::cross(glm::dvec3(vertices[tri[1]].position) - p0, glm::dvec3(vertices[tri[2]].position) - p0);
+                            const double length = glm::length(normal);
+                            for (int v = 0; v < 3; v++) {
+                                vertex_triangles[tri[v]].push_back((int32_t) t);
+                                edges.emplace_back(std::min(tri[v], tri[(v + 1) % 3]), std::max(tri[v], tri[(v + 1) % 3]));
+                                if (length > 0.0) {
+                                    const glm::dvec3 n = normal / length;
+                                    quadrics[tri[v]] += Quadric::plane(n, -glm::dot(n, p0));
+                                }
+                            }
+                        }
+
+                        // Edges on exactly two triangles are interior, anything else pins both ends
+                        std::sort(edges.begin(), edges.end());
+                        for (size_t i = 0; i < edges.size();) {
+                            size_t j = i;
+                            while (j < edges.size() && edges[j] == edges[i]) {
+                                j += 1;
+                            }
+                            if (j - i != 2) {
+                                on_boundary[edges[i].first] = 1;
+                                on_boundary[edges[i].second] = 1;
+                            }
+                            i = j;
+                        }
+                    }
+
+                    /** Assigns vertices & triangles to the chunks of a `chunks`^3 grid over the mesh's bounds,
+                     * shifted by `offset` chunks. Returns the number of chunks. */
+                    int32_t assign_chunks(const int32_t chunks, const float offset) {
+                        glm::vec3 low = glm::vec3(std::numeric_limits<float>::max());
+                        glm::vec3 high = glm::vec3(std::numeric_limits<float>::lowest());
+                        for (size_t v = 0; v < vertices.size(); v++) {
+                            if (!vertex_dead[v]) {
+                                low = glm::min(low, vertices[v].position);
+                                high = glm::max(high, vertices[v].position);
+                            }
+                        }
+
+                        const int32_t per_axis = chunks + (offset > 0.f ? 1 : 0);
+                        const glm::vec3 scale = (float) chunks / glm::max(high - low, glm::vec3(std::numeric_limits<float>::min()));
+                        vertex_chunk.resize(vertices.size());
+                        for (size_t v = 0; v < vertices.size(); v++) {
+                            const glm::ivec3 c = glm::clamp(glm::ivec3(glm::floor((vertices[v].position - low) * scale + offset)), glm::ivec3(0), glm::ivec3(per_axis - 1));
+                            vertex_chunk[v] = c.x + per_axis * (c.y + per_axis * c.z);
+                        }
+
+                        // Triangles reaching across chunks lock all their vertices
+                        const size_t triangle_count = indices.size() / 3;
+                        std::vector<uint8_t> locked(on_boundary);
+                        for (size_t t = 0; t < triangle_count; t++) {
+                            const int32_t* tri = &indices[3 * t];
+                            if (!triangle_dead[t] && (vertex_chunk[tri[0]] != vertex_chunk[tri[1]] || vertex_chunk[tri[0]] != vertex_chunk[tri[2]])) {
+                                locked[tri[0]] = locked[tri[1]] = locked[tri[2]] = 1;
+                            }
+                        }
+                        for (size_t v = 0; v < vertices.size(); v++) {
+                            vertex_chunk[v] = locked[v] ? -1 : vertex_chunk[v];
+                        }
+
+                        const int32_t count = per_axis * per_axis * per_axis;
+                        chunk_triangles.resize((size_t) count);
+                        for (std::vector<int32_t>& list : chunk_triangles) {
+                            list.clear();
+                        }
+                        for (size_t t = 0; t < triangle_count; t++) {
+                            if (triangle_dead[t]) {
+                                continue;
+                            }
+                            // A triangle belongs to the chunk of any of its unlocked vertices (they all agree)
+                            for (int v = 0; v < 3; v++) {
+                                const int32_t chunk = vertex_chunk[indices[3 * t + v]];
+                                if (chunk >= 0) {
+                                    chunk_triangles[chunk].push_back((int32_t) t);
+                                    break;
+                                }
+                            }
+                        }
+                        return count;
+                    }
+
+                    /** Cost & target position of collapsing the edge (a, b) */
+                    Collapse plan(const int32_t a, const int32_t b) const {
+                        Quadric q = quadrics[a];
+                        q += quadrics[b];
+
+                        const glm::dvec3 pa = vertices[a].position;
+                        const glm::dvec3 pb = vertices[b].position;
+                        glm::dvec3 best = (pa + pb) * 0.5;
+                        double cost = q.error(best);
+
+                        // The optimum of a near-flat quadric can land far away, only trust it near the edge
+                        glm::dvec3 optimum;
+                        if (q.minimum(optimum) && glm::length(optimum - best) <= glm::length(pb - pa)) {
+                            best = optimum;
+                            cost = q.error(optimum);
+                        } else {
+                            for (const glm::dvec3& p : { pa, pb }) {
+                                const double error = q.error(p);
+                                if (error < cost) {
+                                    best = p;
+                                    cost = error;
+                                }
+                            }
+                        }
+                        return Collapse { std::fmax(cost, 0.0), a, b, versions[a], versions[b], glm::vec3(best) };
+                    }
+
+                    /** False if moving a & b to `position` & merging them would flip a triangle or leave an
+                     * edge on more than two triangles */
+                    bool can_collapse(const int32_t a, const int32_t b, const glm::vec3& position, std::vector<int32_t>& ring_a, std::vector<int32_t>& ring_b) const {
+                        // Link condition: the only vertices both ends share are the tips of their shared triangles
+                        int32_t shared_triangles = 0;
+                        auto gather = [&](const int32_t v, const int32_t other, std::vector<int32_t>& ring) {
+                            ring.clear();
+                            for (const int32_t t : vertex_triangles[v]) {
+                                if (triangle_dead[t]) {
+                                    continue;
+                                }
+                                const int32_t* tri = &indices[3 * t];
+                                shared_triangles += (int32_t) (v == a && (tri[0] == other || tri[1] == other || tri[2] == other));
+                                for (int k = 0; k < 3; k++) {
+                                    if (tri[k] != v && tri[k] != other) {
+                                        ring.push_back(tri[k]);
+                                    }
+                                }
+                            }
+                            std::sort(ring.begin(), ring.end());
+                            ring.erase(std::unique(ring.begin(), ring.end()), ring.end());
+                        };
+                        gather(a, b, ring_a);
+                        gather(b, a, ring_b);
+
+                        int32_t common = 0;
+                        for (size_t i = 0, j = 0; i < ring_a.size() && j < ring_b.size();) {
+                            if (ring_a[i] == ring_b[j]) {
+                                common += 1;
+                                i += 1;
+                                j += 1;
+                            } else if (ring_a[i] < ring_b[j]) {
+                                i += 1;
+                            } else {
+                                j += 1;
+                            }
+                        }
+                        if (common != shared_triangles) {
+                            return false;
+                        }
+
+                        // No surviving triangle may turn by more than ~80 degrees or collapse to a sliver of nothing
+                        for (const int32_t v : { a, b }) {
+                            for (const int32_t t : vertex_triangles[v]) {
+                                const int32_t* tri = &indices[3 * t];
+                                if (triangle_dead[t] || tri[0] == (v == a ? b : a) || tri[1] == (v == a ? b : a) || tri[2] == (v == a ? b : a)) {
+                                    continue;
+                                }
+
+                                glm::vec3 p[3];
+                                for (int k = 0; k < 3; k++) {
+                                    p[k] = vertices[tri[k]].position;
+                                }
+                                const glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                                for (int k = 0; k < 3; k++) {
+                                    p[k] = tri[k] == v ? position : p[k];
+                                }
+                                const glm::vec3 after = glm::cross(p[1] - p[0], p[2] - p[0]);
+
+                                const float lengths = glm::length(before) * glm::length(after);
+                                if (glm::length(before) > 0.f && glm::dot(before, after) <= 0.2f * lengths) {
+                                    return false;
+                                }
+                            }
+                        }
+                        return true;
+                    }
+
+                    /** Moves a to `position` & merges b into it. Returns the number of triangles removed. */
+                    size_t collapse(const int32_t a, const int32_t b, const glm::vec3& position) {
+                        Vertex& kept = vertices[a];
+                        const glm::vec3 normal = kept.normal + vertices[b].normal;
+                        kept.position = position;
+                        kept.normal = glm::length(normal) > 0.f ? glm::normalize(normal) : kept.normal;
+                        quadrics[a] += quadrics[b];
+
+                        size_t removed = 0;
+                        for (const int32_t t : vertex_triangles[b]) {
+                            if (triangle_dead[t]) {
+                                continue;
+                            }
+                            int32_t* tri = &indices[3 * t];
+                            if (tri[0] == a || tri[1] == a || tri[2] == a) {
+                                triangle_dead[t] = 1;
+                                removed += 1;
+                            } else {
+                                for (int k = 0; k < 3; k++) {
+                                    tri[k] = tri[k] == b ? a : tri[k];
+                                }
+                                vertex_triangles[a].push_back(t);
+                            }
+                        }
+
+                        std::vector<int32_t>& triangles = vertex_triangles[a];
+                        triangles.erase(std::remove_if(triangles.begin(), triangles.end(), [this](const int32_t t) { return triangle_dead[t] != 0; }), triangles.end());
+                        vertex_triangles[b].clear();
+                        vertex_dead[b] = 1;
+                        versions[a] += 1;
+                        versions[b] += 1;
+                        return removed;
+                    }
+
+                    /** Collapses the cheapest edges of `chunk` until it's down to `target` triangles or the next
+                     * collapse would cost more than `max_cost`. Only touches the chunk's own triangles & vertices. */
+                    void decimate_chunk(const int32_t chunk, const size_t target, const double max_cost) {
+                        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+                        auto consider = [&](const int32_t a, const int32_t b) {
+                            if (vertex_chunk[a] == chunk && vertex_chunk[b] == chunk) {
+                                heap.push(plan(std::min(a, b), std::max(a, b)));
+                            }
+                        };
+
+                        for (const int32_t t : chunk_triangles[chunk]) {
+                            const int32_t* tri = &indices[3 * t];
+                            for (int k = 0; k < 3; k++) {
+                                if (tri[k] < tri[(k + 1) % 3]) {
+                                    consider(tri[k], tri[(k + 1) % 3]);
+                                }
+                            }
+                        }
+
+                        size_t live = chunk_triangles[chunk].size();
+                        std::vector<int32_t> ring_a;
+                        std::vector<int32_t> ring_b;
+                        while (live > target && !heap.empty()) {
+                            const Collapse c = heap.top();
+                            heap.pop();
+                            if (c.cost > max_cost) {
+                                break;
+                            }
+                            if (vertex_dead[c.a] || vertex_dead[c.b] || versions[c.a] != c.version_a || versions[c.b] != c.version_b
+                                || !can_collapse(c.a, c.b, c.position, ring_a, ring_b)) {
+                                continue;
+                            }
+
+                            live -= collapse(c.a, c.b, c.position);
+                            for (const int32_t t : vertex_triangles[c.a]) {
+                                const int32_t* tri = &indices[3 * t];
+                                for (int k = 0; k < 3; k++) {
+                                    if (tri[k] != c.a) {
+                                        consider(c.a, tri[k]);
+                                    }
+                                }
+                            }
+                        }
+                    }
+
+                    /** One round of decimation over every chunk of a `chunks`^3 grid shifted by `offset` chunks,
+                     * each chunk given its share of the triangles left to remove */
+                    void decimate_round(const int32_t chunks, const float offset, const DecimationOptions& options) {
+                        const int32_t count = assign_chunks(chunks, offset);
+
+                        size_t live = 0;
+                        for (const uint8_t dead : triangle_dead) {
+                            live += (size_t) !dead;
+                        }
+                        if (live <= options.target_triangles) {
+                            return;
+                        }
+
+                        const size_t excess = live - options.target_triangles;
+                        const double max_cost = (double) options.max_error * (double) options.max_error;
+                        std::atomic<int32_t> next_chunk = 0;
+                        auto work = [&]() {
+                            for (int32_t chunk = next_chunk++; chunk < count; chunk = next_chunk++) {
+                                const size_t owned = chunk_triangles[chunk].size();
+                                const size_t target = options.target_triangles == 0 ? 0 : owned - owned * excess / live;
+                                decimate_chunk(chunk, target, max_cost);
+                            }
+                        };
+
+                        const uint32_t threads = std::min<uint32_t>(std::max<uint32_t>(options.workers, 1), (uint32_t) count);
+                        TaskGroup group(ThreadPool::shared());
+                        for (uint32_t t = 1; t < threads; t++) {
+                            group.run(work);
+                        }
+                        work();
+                        group.wait();
+                    }
+
+                public:
+                    /** Decimates `mesh` in place per `options`. The result is indexed, with every vertex used. */
+                    void decimate(MeshData& mesh, const DecimationOptions& options) {
+                        weld(mesh);
+                        prepare();
+
+                        // Halve the chunks every two rounds, down to a last round over the whole mesh
+                        for (int32_t chunks = std::max(options.chunks, 1); ; chunks /= 2) {
+                            decimate_round(chunks, 0.f, options);
+                            if (chunks == 1) {
+                                break;
+                            }
+                            decimate_round(chunks, 0.5f, options);
+                        }
+
+                        // Keep live triangles & the vertices they use, in first use order
+                        std::vector<int32_t> remap(vertices.size(), -1);
+                        mesh.vertices.clear();
+                        mesh.indices.clear();
+                        for (size_t t = 0; t < triangle_dead.size(); t++) {
+                            if (triangle_dead[t]) {
+                                continue;
+                            }
+                            for (int k = 0; k < 3; k++) {
+                                const int32_t v = indices[3 * t + k];
+                                if (remap[v] < 0) {
+                                    remap[v] = (int32_t) mesh.vertices.size();
+                                    mesh.vertices.push_back(vertices[v]);
+                                }
+                                mesh.indices.push_back(remap[v]);
+                            }
+                        }
+                    }
+            };
+
+            /** Decimates `mesh` in place, see `MeshDecimator` */
+            inline void decimate_mesh(MeshData& mesh, const DecimationOptions& options = DecimationOptions()) {
+                MeshDecimator decimator;
+                decimator.decimate(mesh, options);
+            }
+        }
+    }
+}
\ No newline at end of file
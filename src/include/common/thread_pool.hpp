@@ -0,0 +1,301 @@
+#pragma once
+
+#include "../fieldrange.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mbl {
+    namespace common {
+        class ThreadPool;
+
+        /** Tasks run on a `ThreadPool` that can be waited on together. `wait` runs queued tasks (of
+         * any group) on the calling thread until every task of this group has finished, so groups can
+         * be waited on from inside a task without starving the pool. Tasks must not throw. */
+        class TaskGroup {
+            private:
+                ThreadPool& pool;
+                std::atomic<size_t> unfinished = 0;
+
+                friend class ThreadPool;
+
+            public:
+                explicit TaskGroup(ThreadPool& p_pool) : pool(p_pool) {}
+                TaskGroup(const TaskGroup&) = delete;
+                TaskGroup& operator=(const TaskGroup&) = delete;
+
+                ~TaskGroup() {
+                    wait();
+                }
+
+                /** Queues `f()` to run on the pool */
+                template <typename F>
+                void run(F&& f);
+
+                /** Returns once every task run through this group has finished */
+                void wait();
+        };
+
+        /** Persistent work stealing thread pool, shared by the engine's parallel passes (see `shared`).
+         *
+         * Every worker owns a deque: tasks it queues go on the back & it takes its own work from the
+         * back, while idle workers steal from the front of the others'. Tasks queued from outside
+         * the pool go on a deque of their own, & a thread waiting on a `TaskGroup` works through the
+         * queues with the workers. Idle workers spin for a short while before sleeping, so work handed
+         * out in quick succession (a frame's passes) doesn't pay for waking them each time. */
+        class ThreadPool {
+            private:
+                struct Task {
+                    std::function<void()> run;
+                    TaskGroup* group;
+                };
+
+                struct Queue {
+                    std::mutex mutex;
+                    std::deque<Task> tasks;
+                };
+
+                // How long an idle worker keeps looking for work before it sleeps
+                static constexpr auto SPIN_TIME = std::chrono::microseconds(200);
+
+                std::vector<std::unique_ptr<Queue>> queues;    // queues[0] takes tasks from outside the pool
+                std::vector<std::thread> threads;
+                std::atomic<size_t> queued = 0;
+                std::atomic<size_t> sleepers = 0;
+                std::atomic<bool> stopping = false;
+                std::mutex sleep_mutex;
+                std::condition_variable wake;
+
+                /** Queue of the calling thread if it's one of this pool's workers, 0 otherwise */
+                size_t own_queue() const {
+                    return worker_pool() == this ? worker_index() : 0;
+                }
+
+                static const ThreadPool*& worker_pool() {
+                    static thread_local const ThreadPool* pool = nullptr;
+                    return pool;
+                }
+
+                static size_t& worker_index() {
+                    static thread_local size_t index = 0;
+                    return index;
+                }
+
+                void push(Task&& task) {
+                    // Counted before it's queued so `queued` never drops below the tasks it counts. Pairs
+                    // with the sleeper count going up before `queued` is checked in `work`
+                    queued.fetch_add(1);
+
+                    Queue& queue = *queues[own_queue()];
+                    {
+                        std::lock_guard<std::mutex> lock(queue.mutex);
+                        queue.tasks.push_back(std::move(task));
+                    }
+
+                    if (sleepers.load() > 0) {
+                        std::lock_guard<std::mutex> lock(sleep_mutex);
+                        wake.notify_one();
+                    }
+                }
+
+                /** Takes a task, the newest of the caller's own queue or else the oldest of another's */
+                bool take(Task& task) {
+                    if (queued.load(std::memory_order_relaxed) == 0) {
+                        return false;
+                    }
+
+                    const size_t own = own_queue();
+                    for (size_t k = 0; k < queues.size(); k++) {
+                        Queue& queue = *queues[(own + k) % queues.size()];
+                        std::lock_guard<std::mutex> lock(queue.mutex);
+                        if (queue.tasks.empty()) {
+                            continue;
+                        }
+
+                        if (k == 0) {
+                            task = std::move(queue.tasks.back());
+                            queue.tasks.pop_back();
+                        } else {
+                            task = std::move(queue.tasks.front());
+                            queue.tasks.pop_front();
+                        }
+                        queued.fetch_sub(1);
+                        return true;
+                    }
+                    return false;
+                }
+
+                static void finish(Task& task) {
+                    task.run();
+                    task.group->unfinished.fetch_sub(1, std::memory_order_acq_rel);
+                }
+
+                void work(const size_t index) {
+                    worker_pool() = this;
+                    worker_index() = index;
+
+                    Task task;
+                    while (!stopping.load()) {
+                        if (take(task)) {
+                            finish(task);
+                            continue;
+                        }
+
+                        const auto spin_until = std::chrono::steady_clock::now() + SPIN_TIME;
+                        bool found = false;
+                        while (!found && !stopping.load() && std::chrono::steady_clock::now() < spin_until) {
+                            std::this_thread::yield();
+                            found = queued.load(std::memory_order_relaxed) > 0;
+                        }
+                        if (found) {
+                            continue;
+                        }
+
+                        std::unique_lock<std::mutex> lock(sleep_mutex);
+                        sleepers.fetch_add(1);
+                        wake.wait(lock, [this] { return queued.load() > 0 || stopping.load(); });
+                        sleepers.fetch_sub(1);
+                    }
+                }
+
+                void start(const uint32_t worker_count) {
+                    stopping = false;
+                    queues.clear();
+                    for (uint32_t q = 0; q <= worker_count; q++) {
+                        queues.push_back(std::make_unique<Queue>());
+                    }
+                    for (uint32_t w = 1; w <= worker_count; w++) {
+                        threads.emplace_back(&ThreadPool::work, this, (size_t) w);
+                    }
+                }
+
+                void stop() {
+                    {
+                        std::lock_guard<std::mutex> lock(sleep_mutex);
+                        stopping = true;
+                    }
+                    wake.notify_all();
+                    for (std::thread& thread : threads) {
+                        thread.join();
+                    }
+                    threads.clear();
+                }
+
+                friend class TaskGroup;
+
+            public:
+                /** Starts `worker_count` workers. A pool with none runs every task on the thread waiting for it. */
+                explicit ThreadPool(const uint32_t worker_count) {
+                    start(worker_count);
+                }
+
+                ThreadPool(const ThreadPool&) = delete;
+                ThreadPool& operator=(const ThreadPool&) = delete;
+
+                ~ThreadPool() {
+                    stop();
+                }
+
+                /** The pool shared by every engine stage, with a worker per hardware thread besides the caller */
+                static ThreadPool& shared() {
+                    static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+                    return pool;
+                }
+
+                /** Restarts the pool with `worker_count` workers. Must not be called while tasks are queued
+                 * or running. */
+                void set_workers(const uint32_t worker_count) {
+                    if (worker_count != threads.size()) {
+                        stop();
+                        start(worker_count);
+                    }
+                }
+
+                uint32_t get_workers() const {
+                    return (uint32_t) threads.size();
+                }
+
+                /** Threads that can work at once: the workers & a thread waiting on them */
+                uint32_t concurrency() const {
+                    return (uint32_t) threads.size() + 1;
+                }
+
+                /** Runs one queued task on the calling thread if there is one */
+                bool run_one() {
+                    Task task;
+                    if (!take(task)) {
+                        return false;
+                    }
+                    finish(task);
+                    return true;
+                }
+
+                /** Calls `f(low, high)` over chunks of [begin, end) of at least `grain` indices (but the
+                 * last) in parallel, returning once every chunk is done. The caller runs the first chunk. */
+                template <typename F>
+                void parallel_for(const int64_t begin, const int64_t end, F&& f, const int64_t grain = 1) {
+                    const int64_t count = end - begin;
+                    if (count <= 0) {
+                        return;
+                    }
+
+                    // A few chunks per thread lets stealing even out uneven ones
+                    const int64_t max_chunks = 4 * (int64_t) concurrency();
+                    const int64_t chunks = std::min(max_chunks, (count + std::max<int64_t>(grain, 1) - 1) / std::max<int64_t>(grain, 1));
+                    if (chunks <= 1 || threads.empty()) {
+                        f(begin, end);
+                        return;
+                    }
+
+                    TaskGroup group(*this);
+                    for (int64_t c = chunks - 1; c > 0; c--) {
+                        const int64_t low = begin + c * count / chunks;
+                        const int64_t high = begin + (c + 1) * count / chunks;
+                        group.run([&f, low, high] { f(low, high); });
+                    }
+                    f(begin, begin + count / chunks);
+                    group.wait();
+                }
+
+                /** Calls `f(slab)` over slabs of `range` split along z, of at least `grain` z values each,
+                 * in parallel */
+                template <typename F>
+                void parallel_for(const FieldRange& range, F&& f, const int64_t grain = 1) {
+                    const IndexDim low = range.low();
+                    const IndexDim high = range.high();
+                    parallel_for(low.z, high.z, [&](const int64_t z0, const int64_t z1) {
+                        f(FieldRange({ low.x, high.x, low.y, high.y, (int32_t) z0, (int32_t) z1 }));
+                    }, grain);
+                }
+        };
+
+        template <typename F>
+        void TaskGroup::run(F&& f) {
+            unfinished.fetch_add(1, std::memory_order_relaxed);
+            if (pool.threads.empty()) {
+                f();    // nothing to hand it to
+                unfinished.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+            pool.push(ThreadPool::Task { std::function<void()>(std::forward<F>(f)), this });
+        }
+
+        inline void TaskGroup::wait() {
+            while (unfinished.load(std::memory_order_acquire) > 0) {
+                if (!pool.run_one()) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    }
+}
\ No newline at end of file
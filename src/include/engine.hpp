@@ -2,13 +2,24 @@
 
 // MBL
 #include <isosurface.hpp>
+#include <quantized_isosurface.hpp>
 #include <metaball.hpp>
 #include <marcher.hpp>
 #include <common/graphics.hpp>
+#include <common/compact_mesh.hpp>
+#include <common/thread_pool.hpp>
+#include <scanline.hpp>
+#include <occupancy.hpp>
+#include <flying_edges.hpp>
+#include <surface_nets.hpp>
 
 // STD
 #include <vector>
 #include <array>
+#include <algorithm>
+#include <optional>
+#include <cassert>
+#include <thread>
 
 namespace mbl {
     typedef std::array<glm::vec3,12> LerpedEdgePoints; // Interpolated Edge Points
@@ -31,6 +42,71 @@ namespace mbl {
         const OutIndices& indices;
     };
 
+    /** Handle to a metaball owned by a MetaballEngine. Edits made through
+     * `MetaballEngine::update_metaball` & `MetaballEngine::edit_metaball` are observed by the engine. */
+    struct MetaballHandle {
+        size_t index;
+    };
+
+    /** Record of an observed metaball edit. If the metaball type has a bounding box, `before` & `after` hold
+     * its box prior to the first edit and after the latest edit since changes were last cleared.
+     * Newly added metaballs have no `before` box. */
+    struct MetaballChange {
+        size_t index;
+        bool added;
+        std::optional<BoundingBox> before;
+        std::optional<BoundingBox> after;
+    };
+
+    /** How `MetaballEngine::construct_mesh` finds the cells the surface passes through.
+     *
+     * FullScan: every field node is evaluated & every cell classified. O(volume) per mesh.
+     *
+     * Tracking: for slowly moving scenes. Extraction is seeded from the previous mesh's active cells,
+     *  dilated by how far the metaballs moved, and flood-fills outward only through cells the surface
+     *  crosses. Densities are evaluated lazily at the corners of visited cells, so a mesh costs
+     *  O(surface). Falls back to a full scan every `full_scan_interval` meshes, when the isovalue or
+     *  number of metaballs changes, when a metaball moves more than `max_dilation` cells, and for
+     *  metaball types without bounding boxes (their motion can't be measured).
+     *
+     * Seeded: for a few compact blobs in a large field. From the center of each metaball's bounding box,
+     *  cells are walked along +x until one the surface crosses is found, then the surface is flood-filled
+     *  from there. Only the corners of walked & filled cells are ever evaluated. Surfaces not crossed by
+     *  any center's +x ray (e.g. the inner wall of a hollow shape) are missed. Metaball types without
+     *  bounding boxes get a full scan. */
+    enum class ExtractionMode {
+        FullScan,
+        Tracking,
+        Seeded
+    };
+
+    /** How full scans turn densities into a mesh.
+     *
+     * MarchingCubes: the default. Cells are triangulated one at a time, each triangle with its own 3
+     *  vertices, so every vertex is interpolated (& its normal computed) once per triangle using it.
+     *
+     * FlyingEdges: every crossed edge is interpolated exactly once into a vertex shared by all its
+     *  triangles, giving a watertight indexed mesh with the same triangles, built in row passes that
+     *  are split across threads (see `FlyingEdges`).
+     *
+     * SurfaceNets: one vertex per crossed cell, at the mean of its edge crossings, joined by a quad across
+     *  every crossed edge (see `SurfaceNets`). Indexed like FlyingEdges, with far fewer sliver
+     *  triangles than marching cubes, at the cost of slightly rounder sharp features.
+     *
+     * Tracked & seeded extractions always march cells. */
+    enum class ExtractionBackend {
+        MarchingCubes,
+        FlyingEdges,
+        SurfaceNets
+    };
+
+    /** What the last `construct_mesh` call did */
+    struct ExtractionStats {
+        bool full_scan = true;
+        size_t cells_visited = 0;       // cells whose corners were classified
+        size_t densities_computed = 0;  // field nodes whose density was evaluated
+    };
+
     /** Engine for the construction of Metaballs */
     template <typename M = AggregateMetaball>
     class MetaballEngine {
@@ -41,43 +117,454 @@ namespace mbl {
             std::vector<M> balls;
         
             float isovalue;
-            bool is_dirty = true;
+            bool field_dirty = true;        // Metaballs changed, densities must be recomputed
+            bool threshold_dirty = true;    // Densities or isovalue changed, the mesh must be re-marched
+            bool layers_dirty = true;       // Same as above, but for `construct_meshes`
 
             int32_t num_valid_points = 0;
             common::graphics::MeshData mesh_data;
+            uint64_t mesh_revision = 0;     // Bumped every time `mesh_data` is rebuilt
+
+            // Mesh buffers are cleared but never shrunk, so once they've grown to fit the scene no
+            // mesh allocates. They are reserved from smoothed estimates of recent vertex & index counts,
+            // kept apart as only marching cubes gives every vertex exactly one index
+            static constexpr float MESH_ESTIMATE_SMOOTHING = 0.25f;
+            static constexpr float MESH_ESTIMATE_HEADROOM = 1.25f;
+            float vertex_estimate = 0.f;
+            float index_estimate = 0.f;
+
+            std::vector<MetaballChange> changes;
+            std::vector<int32_t> change_slots;  // per metaball index into `changes`, or -1
+            bool untracked_change = false;
+
+            std::vector<float> layer_isovalues;
+            std::vector<common::graphics::MeshData> layer_meshes;
+
+            ExtractionMode extraction_mode = ExtractionMode::FullScan;
+            ExtractionBackend extraction_backend = ExtractionBackend::MarchingCubes;
+            FlyingEdges flying_edges;
+            SurfaceNets surface_nets;
+            ExtractionStats extraction_stats;
+            bool densities_complete = false;            // every field node holds a current density
+            uint64_t field_revision = 0;                // bumped every time every density is recomputed
+            uint32_t density_workers = 1;               // chunks density evaluation is split into on the shared pool
+            uint32_t full_scan_interval = 60;
+            int32_t max_dilation = 2;
+            uint32_t meshes_since_full_scan = 0;
+
+            // Auto-fit state, the field's bounds in whole cells of `fit_cell_size` from the origin
+            static constexpr int32_t DEFAULT_MAX_FIT_PARTITIONS = 256;
+            static constexpr float MAX_FIT_CELL = (float) (1 << 30);   // cell coordinates past this would overflow IndexDim
+            float fit_cell_size = 0.f;                  // 0 while the field's bounds are fixed
+            float fit_margin = 0.f;
+            int32_t fit_max_partitions = DEFAULT_MAX_FIT_PARTITIONS;
+            IndexDim fit_low = IndexDim(0);
+            IndexDim fit_partitions = IndexDim(0);
+
+            // Sparse extraction state. Bitsets are cleared through the lists of set bits, so
+            // resetting them costs as much as the last extraction did rather than the whole field
+            std::vector<uint64_t> known_nodes;          // node density is current
+            std::vector<int32_t> known_node_list;
+            std::vector<uint64_t> visited_cells;        // cell (keyed by its lowest corner node) was classified
+            std::vector<int32_t> visited_cell_list;
+            std::vector<int32_t> active_cells;          // cells the surface crossed in the last extraction
+            std::vector<int32_t> previous_active_cells;
+            std::vector<int32_t> cell_stack;
+            std::vector<BoundingBox> extracted_bounds;  // metaball bounds as of the last extraction
+
+            OccupancyVolume occupancy;                  // inside bits of every node against `isovalue`, when current
+            ScanlineClassifier row_classifier;
+            std::vector<uint8_t> row_cases;             // case byte of every cell in the row being marched, per layer
+            std::vector<uint8_t> row_layers_crossed;    // whether each layer's surface crosses the row
+
+            /** Buffers `sum_separable` works in, kept so repeated evaluations don't allocate */
+            struct SeparableScratch {
+                std::array<std::vector<float>, 3> coordinates;  // node coordinates along each axis
+                std::array<std::vector<float>, 3> factors;      // factor of every term at each coordinate, per axis
+                std::vector<int32_t> x_offsets;                 // part of a node's index its x contributes
+                std::vector<float> rows;                        // a row of densities per chunk
+            };
+            SeparableScratch separable_scratch;
+
+            /** Buffers reused by every cube visited during a single march */
+            struct MarchScratch {
+                LerpedEdgePoints lerped_edge_points = {};
+                OutVertices cube_out_vertices = {};
+                OutIndices cube_out_indices = {};
+            };
+
+            /** Returns the bounding box of `m` if `M` has one */
+            static std::optional<BoundingBox> bounds_of(const M& m) {
+                if constexpr (HasBoundingBox<M>::value) {
+                    return m.get_bounding_box();
+                } else {
+                    return std::nullopt;
+                }
+            }
+
+            /** Records that the metaball at `index` is about to change. */
+            void record_before(const size_t index, const bool added) {
+                field_dirty = true;
+                if (change_slots.size() <= index) {
+                    change_slots.resize(balls.size(), -1);
+                }
+
+                if (change_slots[index] == -1) {
+                    change_slots[index] = (int32_t) changes.size();
+                    changes.push_back(MetaballChange { index, added, added ? std::nullopt : bounds_of(balls[index]), std::nullopt });
+                }
+            }
+
+            /** Records the state of the metaball at `index` after it has changed */
+            void record_after(const size_t index) {
+                changes[change_slots[index]].after = bounds_of(balls[index]);
+            }
+
+            static bool test_bit(const std::vector<uint64_t>& bits, const int32_t i) {
+                return (bits[i >> 6] >> (i & 63)) & 0x1;
+            }
+
+            static void set_bit(std::vector<uint64_t>& bits, const int32_t i) {
+                bits[i >> 6] |= uint64_t(1) << (i & 63);
+            }
+
+            static void reset_bits(std::vector<uint64_t>& bits, std::vector<int32_t>& set_list, const size_t size) {
+                // Cleared before resizing, the field may have been reshaped since these bits were set
+                for (const int32_t i : set_list) {
+                    bits[i >> 6] = 0;
+                }
+                bits.resize((size + 63) / 64, 0);
+                set_list.clear();
+            }
+
+            /** Reserves room for `estimate` elements in `buffer`, with some headroom */
+            template <typename T>
+            static void reserve_estimated(std::vector<T>& buffer, const float estimate) {
+                // Growing by at least half keeps a slowly rising estimate from reallocating every mesh
+                const size_t capacity = buffer.capacity();
+                const size_t expected = (size_t) std::ceil(estimate * MESH_ESTIMATE_HEADROOM);
+                if (expected > capacity) {
+                    buffer.reserve(std::max(expected, capacity + capacity / 2));
+                }
+            }
+
+            /** Clears `mesh_data` & reserves room for the vertex & index counts expected of the next mesh */
+            void prepare_mesh_data() {
+                mesh_data.vertices.clear();
+                mesh_data.indices.clear();
+                reserve_estimated(mesh_data.vertices, vertex_estimate);
+                reserve_estimated(mesh_data.indices, index_estimate);
+            }
+
+            /** Folds the size of the mesh just built into the estimates used by `prepare_mesh_data` */
+            void update_mesh_estimates() {
+                const float vertices = (float) mesh_data.vertices.size();
+                const float indices = (float) mesh_data.indices.size();
+                vertex_estimate = mesh_revision == 0 ? vertices : vertex_estimate + MESH_ESTIMATE_SMOOTHING * (vertices - vertex_estimate);
+                index_estimate = mesh_revision == 0 ? indices : index_estimate + MESH_ESTIMATE_SMOOTHING * (indices - index_estimate);
+            }
+
+            /** Density of field node `node`, evaluated on first use since the last `begin_sparse_extraction` */
+            float lazy_density(const int32_t node);
+
+            /** Calls `f(begin, end)` over chunks of [0, points) on the shared pool, each whole density
+             * batches & none smaller than MIN_DENSITY_CHUNK points */
+            template <typename F>
+            void for_each_density_chunk(const size_t points, F&& f) const;
+
+            /** Sums the metaballs at nodes [begin, end), `position_of(i)` giving each node's position &
+             * `store(i, density)` taking its sum */
+            template <typename PositionFn, typename StoreFn>
+            void sum_nodes(const size_t begin, const size_t end, PositionFn&& position_of, StoreFn&& store) const;
+
+            /** Sums metaballs satisfying `HasSeparableTerms` over every node of the field `compactor` indexes
+             * from 1D factors along each axis, `position_of(node)` giving node positions & `store(i, density)`
+             * taking the sum of node `i`. Works in `scratch`, which only allocates while it grows. */
+            template <typename PositionFn, typename StoreFn>
+            void sum_separable(SeparableScratch& scratch, const IndexCompactor& compactor, PositionFn&& position_of, StoreFn&& store) const;
+
+            /** Forget every lazily evaluated density, visited cell & the previous mesh */
+            void begin_sparse_extraction();
+
+            /** Marks `cell` visited & classifies it. If the surface crosses it, it is triangulated into
+             * `mesh_data` & every face-adjacent cell sharing a crossed face is flood-filled in turn. */
+            void flood_fill_from(const int32_t cell, CubeOrderedIsopoints& cube_isopoints, MarchScratch& scratch);
+
+            /** Decides whether a tracked extraction can follow the previous surface. If so, `dilation`
+             * is set to the number of cells the metaballs may have carried the surface. */
+            bool can_track(int32_t& dilation) const;
+
+            /** Marches every cell of the field against each of the `layers` thresholds into the matching
+             * mesh of `outs`, a row of cells at a time. Each row is classified against every threshold
+             * before any of it is marched, so the field is walked once however many layers there are.
+             * The cells the surface crosses are appended onto `crossed` if it isn't null (one layer only). */
+            void march_rows(const float* thresholds, common::graphics::MeshData* outs, const size_t layers, std::vector<int32_t>* crossed);
+
+            /** Marches every cell of the field, the default extraction */
+            void full_scan();
+
+            /** Marches only the cells reached from the previous surface dilated by `dilation` cells */
+            void track_surface(const int32_t dilation);
+
+            /** Marches only the cells reached from each metaball's center */
+            void seed_from_centers();
+
+            /** Records every metaball's bounds for the next `can_track` */
+            void remember_bounds();
+
+            /** With auto-fit on, reshapes the field around the metaballs' joined bounds if they moved
+             * into other cells. Cells the previous surface crossed are carried over to the new layout. */
+            void fit_field();
+
+            /** Triangulates a single cube with corner bits `cube_bits` against `threshold`, appending the
+             * triangles onto `out`. */
+            void march_cube(
+                const uint8_t cube_bits, 
+                const CubeOrderedIsopoints& cube_isopoints, 
+                const float threshold, 
+                common::graphics::MeshData& out, 
+                MarchScratch& scratch
+            );
 
         public:
             /** Create a Metaball engine that constructs a `SCALAR FIELD` centered on `center` with a side length of `side_length`,
              * a resolution (# of divisions per axis in the scalar field), and an isovalue to test passed in metaballs against. */
             MetaballEngine(const glm::vec3& center, const float side_length, const int32_t resolution, const float isovalue = 1.0f);
 
-            ~MetaballEngine() {}
-
             /** Add a metaball to this metaball engine. The index of the metaball is returned. */
             size_t add_metaball(M&& m) {
                 size_t index = balls.size();
                 balls.push_back(m);
-                is_dirty = true;
+                record_before(index, true);
+                record_after(index);
                 return index;
             }
 
-            /** Get the metaball in this Metaball Engine at index i */
+            /** Get the metaball in this Metaball Engine at index i. Edits made through the returned
+             * reference are not observed by the engine, call `make_dirty` afterwards (or prefer `update_metaball`). */
             M& get_metaball(size_t i) {
                 return balls[i];
             }
 
+            const M& get_metaball(size_t i) const {
+                return balls[i];
+            }
+
+            /** All metaballs in this engine, in index order */
+            const std::vector<M>& get_metaballs() const {
+                return balls;
+            }
+
+            /** The scalar field meshes are extracted from. Densities are only all current after a
+             * full scan or `update_densities`. */
+            const IsoSurface& get_field() const {
+                return field;
+            }
+
+            /** The scalar field with every density current, recomputing them first if metaballs changed
+             * or the last mesh was extracted sparsely. Under `set_auto_fit` the field is refitted first. */
+            const IsoSurface& get_complete_field() {
+                if (field_dirty) {
+                    fit_field();
+                }
+                if (field_dirty || !densities_complete) {
+                    update_densities();
+                }
+                return field;
+            }
+
+            /** Returns a counter bumped every time every density of the field is recomputed. Equal
+             * revisions from `get_complete_field` mean equal densities. */
+            uint64_t get_field_revision() const {
+                return field_revision;
+            }
+
+            /** Swaps this engine's metaballs with `other`. Since every metaball may have changed, this
+             * counts as an untracked change (see `make_dirty`). */
+            MetaballEngine<M>& swap_metaballs(std::vector<M>& other) {
+                clear_changes();
+                change_slots.clear();
+                balls.swap(other);
+                return make_dirty();
+            }
+
+            /** Returns the number of metaballs in this engine */
+            size_t num_metaballs() const {
+                return balls.size();
+            }
+
+            /** Get a handle to the metaball at index i */
+            MetaballHandle handle_of(size_t i) const {
+                assert(i < balls.size());
+                return MetaballHandle { i };
+            }
+
+            /** Calls `fn(M&)` on the metaball behind `handle`, recording the change and its bounds. */
+            template <typename F>
+            MetaballEngine<M>& update_metaball(const MetaballHandle handle, F&& fn) {
+                record_before(handle.index, false);
+                fn(balls[handle.index]);
+                record_after(handle.index);
+                return *this;
+            }
+
+            /** Scoped write access to a metaball. The change is recorded when the guard is destroyed. */
+            class WriteGuard {
+                private:
+                    MetaballEngine<M>* engine;
+                    size_t index;
+                public:
+                    WriteGuard(MetaballEngine<M>& e, const size_t i) : engine(&e), index(i) {
+                        engine->record_before(index, false);
+                    }
+
+                    WriteGuard(const WriteGuard&) = delete;
+                    WriteGuard& operator=(const WriteGuard&) = delete;
+
+                    ~WriteGuard() {
+                        engine->record_after(index);
+                    }
+
+                    M& operator*() { return engine->balls[index]; }
+                    M* operator->() { return &engine->balls[index]; }
+            };
+
+            /** Returns a guard through which the metaball behind `handle` can be edited.
+             * 
+             * @code
+             * {
+             *     auto ball = engine.edit_metaball(handle);
+             *     ball->unwrap().m_center += offset;
+             * } // change recorded here
+             * @endcode
+             * */
+            WriteGuard edit_metaball(const MetaballHandle handle) {
+                return WriteGuard(*this, handle.index);
+            }
+
+            /** Metaball edits observed since the last `clear_changes`, at most one per metaball. */
+            const std::vector<MetaballChange>& get_changes() const {
+                return changes;
+            }
+
+            /** True when `make_dirty` was called since the last `clear_changes`, meaning unobserved
+             * edits may have happened & `get_changes` can't be relied on. */
+            bool has_untracked_changes() const {
+                return untracked_change;
+            }
+
+            MetaballEngine<M>& clear_changes() {
+                for (const MetaballChange& change : changes) {
+                    change_slots[change.index] = -1;
+                }
+                changes.clear();
+                untracked_change = false;
+                return *this;
+            }
+
+            /** Indicate that the metaballs have changed, so densities will be recomputed
+             * on the next `construct_mesh` call. */
             MetaballEngine<M>& make_dirty() {
-                is_dirty = true;
+                field_dirty = true;
+                untracked_change = true;
                 return *this;
             }
 
-            /** Set the current isovalue of the Metaball engine to a different value */
+            /** Set the current isovalue of the Metaball engine to a different value. Only the
+             * march is redone on the next `construct_mesh`, the densities are kept. */
             MetaballEngine<M>& set_isovalue(const float p_isovalue) { 
-                is_dirty = is_dirty || (p_isovalue != isovalue);
+                threshold_dirty = threshold_dirty || (p_isovalue != isovalue);
                 isovalue = p_isovalue;
                 return *this; 
             }
 
+            float get_isovalue() const {
+                return isovalue;
+            }
+
+            /** Choose how `construct_mesh` finds the surface, see `ExtractionMode` */
+            MetaballEngine<M>& set_extraction_mode(const ExtractionMode mode) {
+                extraction_mode = mode;
+                meshes_since_full_scan = full_scan_interval;    // (re)start from a full scan
+                return *this;
+            }
+
+            ExtractionMode get_extraction_mode() const {
+                return extraction_mode;
+            }
+
+            /** Pick how full scans build meshes, see `ExtractionBackend`. `workers` is the number of threads
+             * the FlyingEdges backend may use, 0 for one per hardware thread. */
+            MetaballEngine<M>& set_extraction_backend(const ExtractionBackend backend, const uint32_t workers = 0) {
+                if (extraction_backend != backend) {
+                    threshold_dirty = true;
+                }
+                extraction_backend = backend;
+                flying_edges.set_workers(workers == 0 ? std::thread::hardware_concurrency() : workers);
+                return *this;
+            }
+
+            ExtractionBackend get_extraction_backend() const {
+                return extraction_backend;
+            }
+
+            /** Refit the field before every mesh to the metaballs' joined bounding boxes grown by `margin`,
+             * in cells of side `cell_size` aligned to the origin, rather than the cube the engine was
+             * made with. Sparse scenes then only pay for the cells near their metaballs. The field's
+             * storage is reused across refits. Requires metaballs with bounding boxes.
+             *
+             * Bounds wider than `max_partitions` cells along an axis are cut down to that many cells
+             * around their middle, so a metaball flying off can't grow the field without limit. Bounds
+             * that aren't finite (or too far out to index) leave the field where it was. */
+            MetaballEngine<M>& set_auto_fit(const float cell_size, const float margin = 0.f, const int32_t max_partitions = DEFAULT_MAX_FIT_PARTITIONS) {
+                static_assert(HasBoundingBox<M>::value, "engine.hpp: MetaballEngine<M>::set_auto_fit -> M has no bounding box to fit.");
+                assert(cell_size > 0.f && max_partitions > 0);
+                fit_cell_size = cell_size;
+                fit_margin = std::max(margin, 0.f);
+                fit_max_partitions = max_partitions;
+                fit_partitions = IndexDim(0);       // refit on the next mesh even if the bounds didn't move
+                field_dirty = true;
+                return *this;
+            }
+
+            /** Stop refitting, the field keeps its last bounds */
+            MetaballEngine<M>& disable_auto_fit() {
+                fit_cell_size = 0.f;
+                return *this;
+            }
+
+            bool is_auto_fit() const {
+                return fit_cell_size > 0.f;
+            }
+
+            /** Split density evaluation & the FlyingEdges backend's passes across up to `workers` threads
+             * of the shared `common::ThreadPool`, 0 for one per hardware thread & 1 to stay on the calling
+             * thread. Size the pool itself with `common::ThreadPool::shared().set_workers`. */
+            MetaballEngine<M>& set_workers(const uint32_t workers) {
+                density_workers = workers == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : workers;
+                flying_edges.set_workers(density_workers);
+                return *this;
+            }
+
+            /** Tune `ExtractionMode::Tracking`: a full scan is forced every `p_full_scan_interval` meshes, or
+             * when a metaball's bounds moved more than `p_max_dilation` cells since the last mesh. */
+            MetaballEngine<M>& set_tracking_options(const uint32_t p_full_scan_interval, const int32_t p_max_dilation) {
+                full_scan_interval = std::max<uint32_t>(p_full_scan_interval, 1);
+                max_dilation = std::max<int32_t>(p_max_dilation, 0);
+                return *this;
+            }
+
+            /** What the last `construct_mesh` call that rebuilt the mesh did */
+            const ExtractionStats& get_extraction_stats() const {
+                return extraction_stats;
+            }
+
+            /** Returns a counter bumped every time `construct_mesh` actually rebuilds the mesh. Equal
+             * revisions mean equal meshes, so uploads of an unchanged mesh can be skipped. */
+            uint64_t get_mesh_revision() const {
+                return mesh_revision;
+            }
+
             /** Returns the sum of all metaballs in the metaball engine
              * given x, y, and z coordinates. */
             float sum_metaballs(const float x, const float y, const float z) const;
@@ -96,27 +583,71 @@ namespace mbl {
              * this MetaballEngine spans over. */
             MetaballEngine& update_densities();
 
+            /** Computes the densities of the field's points [begin, end) */
+            void evaluate_densities(const size_t begin, const size_t end);
+
+            /** Sums the metaballs at every node of `target`, accumulating in float & quantizing each
+             * density as it's stored. Split across the shared pool like `update_densities`. */
+            template <typename Density>
+            void evaluate_field(BasicIsoSurface<Density>& target) const;
+
             /** Given a CubeView obtained by iterating through a Marching Cube Range, return the cube bits of
              * said cube where 0 means the cube bit is below the isovalue and 1 is equal to or above the
              * isovalue. Along with the cube bits a reference to the passed in CubeOrderedIsopoints array
              * is returned such that the bit ordering matches the IsoPoint ordering. */
             CubeBitsResult compute_cube_bits(CubeView& cube_view, CubeOrderedIsopoints& cube_isopoints);
 
+            /** Same as above, but tests against `threshold` instead of the engine's isovalue. */
+            CubeBitsResult compute_cube_bits(CubeView& cube_view, CubeOrderedIsopoints& cube_isopoints, const float threshold);
+
+            /** Returns the cube bits of already gathered cube isopoints tested against `threshold`. */
+            static uint8_t cube_bits_of(const CubeOrderedIsopoints& cube_isopoints, const float threshold);
+
             /** Interpolate cube edge points. */
             const LerpedEdgePoints& lerp_cube_edges(uint16_t cube_edge_bits, LerpedEdgePoints& cube_edge_points, const CubeOrderedIsopoints& cube_isopoints);
 
+            /** Interpolate cube edge points against `threshold` instead of the engine's isovalue. */
+            const LerpedEdgePoints& lerp_cube_edges(uint16_t cube_edge_bits, LerpedEdgePoints& cube_edge_points, const CubeOrderedIsopoints& cube_isopoints, const float threshold);
+
             /** Build cube tris. */
             CubeTriData build_cube_tris(const uint8_t cube_bits, const LerpedEdgePoints& leps, OutVertices& out_vertices, OutIndices& out_indices);
 
+            /** Build cube tris, numbering the indices from `index_offset`. */
+            CubeTriData build_cube_tris(const uint8_t cube_bits, const LerpedEdgePoints& leps, OutVertices& out_vertices, OutIndices& out_indices, const int32_t index_offset);
+
             /** Given an IsoField with set densities, constructs vertex
              * data from said field. */
             const common::graphics::MeshData& construct_mesh();
+
+            /** Same as `construct_mesh`, but quantized into `out`: positions become 16-bit fixed point
+             * relative to the field's bounds, normals are octahedron encoded into 2 x `N` (int8_t or
+             * int16_t) & indices are 16-bit whenever the mesh has fewer than 65536 vertices. `out` is
+             * only re-encoded when the mesh was rebuilt since it was last passed in. */
+            template <typename N>
+            const common::graphics::CompactMeshData<N>& construct_mesh(common::graphics::CompactMeshData<N>& out);
+
+            /** Evaluates `target` (see `evaluate_field`) & extracts its isosurface at the engine's isovalue
+             * into `out` with Flying Edges. The engine's own field & mesh are untouched, so a field of
+             * 16 bit densities can stand in for one too large to hold as `IsoPoint`s. */
+            template <typename Density>
+            void construct_mesh(BasicIsoSurface<Density>& target, common::graphics::MeshData& out) const;
+
+            /** Constructs one mesh per isovalue in `isovalues` in a single pass over the field's cubes,
+             * e.g. for nested shells. The engine's own isovalue & `construct_mesh` result are untouched.
+             * Meshes are returned in the same order as `isovalues`. */
+            const std::vector<common::graphics::MeshData>& construct_meshes(const std::vector<float>& isovalues);
     };
 
     // MetaballEngine implementations
     
     #include "../MarchingCubes.hpp"
 
+    /** Number of field points gathered per `compute_batch` call for metaballs satisfying `HasBatchCompute` */
+    static constexpr size_t DENSITY_BATCH_SIZE = 256;
+
+    /** Fewest field points worth handing to another thread in `update_densities` */
+    static constexpr size_t MIN_DENSITY_CHUNK = 1 << 14;
+
     static constexpr IndexDim cube_index_offsets[8] = {
         {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
         {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}
@@ -180,19 +711,209 @@ namespace mbl {
 
     template <typename M>
     MetaballEngine<M>& MetaballEngine<M>::update_densities() {
-        num_valid_points = 0;
-        for (IsoPoint& field_point : field.isopoints() ) {
-            field_point.density = sum_metaballs(field_point.position);
-            num_valid_points += (int32_t) (field_point.density >= isovalue);
+        field_dirty = false;
+        threshold_dirty = true;
+        layers_dirty = true;
+        densities_complete = true;
+        field_revision += 1;
+
+        if constexpr (HasSeparableTerms<M>::value) {
+            std::vector<IsoPoint>& points = field.isopoints();
+            sum_separable(separable_scratch, field.compactor(),
+                [this](const int32_t i) -> const glm::vec3& { return field.get_position((uint32_t) i); },
+                [&points](const int32_t i, const float density) { points[i].density = density; });
+        } else {
+            for_each_density_chunk(field.indices(), [this](const size_t begin, const size_t end) {
+                evaluate_densities(begin, end);
+            });
         }
+
+        occupancy.build(field, isovalue);
+        num_valid_points = (int32_t) occupancy.count();
         return *this;
     }
 
+    template <typename M>
+    template <typename F>
+    void MetaballEngine<M>::for_each_density_chunk(const size_t points, F&& f) const {
+        const size_t chunks = std::min<size_t>(density_workers, std::max<size_t>(points / MIN_DENSITY_CHUNK, 1));
+        if (chunks <= 1) {
+            f((size_t) 0, points);
+            return;
+        }
+
+        const size_t grain = (points / chunks + DENSITY_BATCH_SIZE - 1) / DENSITY_BATCH_SIZE * DENSITY_BATCH_SIZE;
+        common::ThreadPool::shared().parallel_for(0, (int64_t) points, [&f](const int64_t begin, const int64_t end) {
+            f((size_t) begin, (size_t) end);
+        }, (int64_t) grain);
+    }
+
+    template <typename M>
+    template <typename PositionFn, typename StoreFn>
+    void MetaballEngine<M>::sum_nodes(const size_t begin, const size_t end, PositionFn&& position_of, StoreFn&& store) const {
+        if constexpr (HasBatchCompute<M>::value) {
+            // Gather positions into contiguous batches so metaballs that support it
+            // can evaluate many points per call
+            std::array<float, DENSITY_BATCH_SIZE> xs, ys, zs, out;
+
+            for (size_t start = begin; start < end; start += DENSITY_BATCH_SIZE) {
+                const size_t n = std::min(DENSITY_BATCH_SIZE, end - start);
+                for (size_t j = 0; j < n; j++) {
+                    const glm::vec3 position = position_of(start + j);
+                    xs[j] = position.x;
+                    ys[j] = position.y;
+                    zs[j] = position.z;
+                    out[j] = 0.f;
+                }
+
+                for (const M& ball : balls) {
+                    ball.compute_batch(xs.data(), ys.data(), zs.data(), out.data(), n);
+                }
+
+                for (size_t j = 0; j < n; j++) {
+                    store(start + j, out[j]);
+                }
+            }
+        } else {
+            for (size_t i = begin; i < end; i++) {
+                store(i, sum_metaballs(position_of(i)));
+            }
+        }
+    }
+
+    template <typename M>
+    template <typename PositionFn, typename StoreFn>
+    void MetaballEngine<M>::sum_separable(SeparableScratch& scratch, const IndexCompactor& compactor, PositionFn&& position_of, StoreFn&& store) const {
+        const IndexDim shape = compactor.dimensions();
+        const std::array<size_t, 3> lengths = { (size_t) shape.x, (size_t) shape.y, (size_t) shape.z };
+
+        // Nodes are placed axis by axis, so each axis' coordinates can be read off the nodes along it
+        for (int32_t axis = 0; axis < 3; axis++) {
+            scratch.coordinates[axis].resize(lengths[axis]);
+            for (size_t i = 0; i < lengths[axis]; i++) {
+                scratch.coordinates[axis][i] = position_of(compactor.flatten_at((int32_t) i, axis))[axis];
+            }
+        }
+
+        // Every term of every ball, one after the other, with its factor at each coordinate of each axis
+        size_t terms = 0;
+        for (const M& ball : balls) {
+            terms += ball.separable_terms();
+        }
+
+        for (int32_t axis = 0; axis < 3; axis++) {
+            scratch.factors[axis].resize(terms * lengths[axis]);
+            size_t term = 0;
+            for (const M& ball : balls) {
+                ball.axis_factors((size_t) axis, scratch.coordinates[axis].data(), lengths[axis], scratch.factors[axis].data() + term * lengths[axis]);
+                term += ball.separable_terms();
+            }
+        }
+
+        const size_t nx = lengths[0];
+        const size_t ny = lengths[1];
+        const size_t nz = lengths[2];
+        scratch.x_offsets.resize(nx);
+        for (size_t x = 0; x < nx; x++) {
+            scratch.x_offsets[x] = compactor.flatten_at((int32_t) x, 0);
+        }
+
+        // Rows (y, z) are split into as many chunks as `for_each_density_chunk` would make, each
+        // summing into its own row of `scratch.rows`
+        const size_t rows = ny * nz;
+        const size_t chunks = std::min<size_t>(density_workers, std::max<size_t>(nx * rows / MIN_DENSITY_CHUNK, 1));
+        scratch.rows.resize(chunks * nx);
+
+        const auto sum_rows = [&](const size_t chunk) {
+            float* row = scratch.rows.data() + chunk * nx;
+            const float* x_factors = scratch.factors[0].data();
+            const float* y_factors = scratch.factors[1].data();
+            const float* z_factors = scratch.factors[2].data();
+
+            for (size_t r = chunk * rows / chunks; r < (chunk + 1) * rows / chunks; r++) {
+                const size_t y = r % ny;
+                const size_t z = r / ny;
+
+                std::fill(row, row + nx, 0.f);
+                for (size_t t = 0; t < terms; t++) {
+                    const float yz = y_factors[t * ny + y] * z_factors[t * nz + z];
+                    const float* xs = x_factors + t * nx;
+                    for (size_t x = 0; x < nx; x++) {
+                        row[x] += xs[x] * yz;
+                    }
+                }
+
+                const int32_t row_offset = compactor.flatten_at((int32_t) y, 1) + compactor.flatten_at((int32_t) z, 2);
+                for (size_t x = 0; x < nx; x++) {
+                    store(row_offset + scratch.x_offsets[x], row[x]);
+                }
+            }
+        };
+
+        if (chunks <= 1) {
+            sum_rows(0);
+            return;
+        }
+        common::ThreadPool::shared().parallel_for(0, (int64_t) chunks, [&sum_rows](const int64_t low, const int64_t high) {
+            for (int64_t chunk = low; chunk < high; chunk++) {
+                sum_rows((size_t) chunk);
+            }
+        });
+    }
+
+    template <typename M>
+    void MetaballEngine<M>::evaluate_densities(const size_t begin, const size_t end) {
+        std::vector<IsoPoint>& points = field.isopoints();
+        sum_nodes(begin, end,
+            [&points](const size_t i) -> const glm::vec3& { return points[i].position; },
+            [&points](const size_t i, const float density) { points[i].density = density; });
+    }
+
+    template <typename M>
+    template <typename Density>
+    void MetaballEngine<M>::evaluate_field(BasicIsoSurface<Density>& target) const {
+        if constexpr (HasSeparableTerms<M>::value) {
+            SeparableScratch scratch;
+            sum_separable(scratch, target.compactor(),
+                [&target](const int32_t i) { return target.get_position((uint32_t) i); },
+                [&target](const int32_t i, const float density) { target.set_density((uint32_t) i, density); });
+            return;
+        }
+
+        for_each_density_chunk(target.indices(), [this, &target](const size_t begin, const size_t end) {
+            sum_nodes(begin, end,
+                [&target](const size_t i) { return target.get_position((uint32_t) i); },
+                [&target](const size_t i, const float density) { target.set_density((uint32_t) i, density); });
+        });
+    }
+
+    template <typename M>
+    template <typename Density>
+    void MetaballEngine<M>::construct_mesh(BasicIsoSurface<Density>& target, common::graphics::MeshData& out) const {
+        evaluate_field(target);
+
+        OccupancyVolume target_occupancy;
+        target_occupancy.build(target, isovalue);
+
+        FlyingEdges extractor;
+        extractor.set_workers(density_workers);
+        extractor.extract(target, target_occupancy, isovalue, [this](const glm::vec3& p) { return compute_normal(p); }, out);
+    }
+
     template <typename M>
     CubeBitsResult MetaballEngine<M>::compute_cube_bits(
         CubeView& cube_view, 
         CubeOrderedIsopoints& cube_isopoints
     ) {
+        return compute_cube_bits(cube_view, cube_isopoints, isovalue);
+    }
+
+    template <typename M>
+    CubeBitsResult MetaballEngine<M>::compute_cube_bits(
+        CubeView& cube_view, 
+        CubeOrderedIsopoints& cube_isopoints,
+        const float threshold
+    ) {
 
         uint8_t cube_bits = 0;
         uint8_t mask = 0x1;
@@ -201,7 +922,7 @@ namespace mbl {
         // Set each bit in cube_bit based on whether its corresponding isopoint satisfies the isovalue threshold
         for (const IndexDim& offset : cube_index_offsets) {
             IsoPoint& cube_point = cube_view.at(offset.x, offset.y, offset.z);
-            cube_bits = cube_bits | (mask * (uint8_t) (cube_point.density >= isovalue));
+            cube_bits = cube_bits | (mask * (uint8_t) (cube_point.density >= threshold));
             mask = mask << 1;
 
             cube_isopoints[cube_isopoint_index] = &cube_point;
@@ -214,11 +935,30 @@ namespace mbl {
         };
     }
 
+    template <typename M>
+    uint8_t MetaballEngine<M>::cube_bits_of(const CubeOrderedIsopoints& cube_isopoints, const float threshold) {
+        uint8_t cube_bits = 0;
+        for (uint8_t i = 0; i < 8; i++) {
+            cube_bits = cube_bits | ((uint8_t) (cube_isopoints[i]->density >= threshold) << i);
+        }
+        return cube_bits;
+    }
+
     template <typename M>
     const LerpedEdgePoints& MetaballEngine<M>::lerp_cube_edges(
         uint16_t cube_edge_bits, 
         LerpedEdgePoints& cube_edge_points,
         const CubeOrderedIsopoints& cube_isopoints
+    ) {
+        return lerp_cube_edges(cube_edge_bits, cube_edge_points, cube_isopoints, isovalue);
+    }
+
+    template <typename M>
+    const LerpedEdgePoints& MetaballEngine<M>::lerp_cube_edges(
+        uint16_t cube_edge_bits, 
+        LerpedEdgePoints& cube_edge_points,
+        const CubeOrderedIsopoints& cube_isopoints,
+        const float threshold
     ) {
         uint8_t cube_edge_index = 0;
         while (cube_edge_bits != 0) {
@@ -228,7 +968,7 @@ namespace mbl {
                 const IsoPoint& I2 = *cube_isopoints[edge[1]];
 
                 float denominator = I2.density - I1.density;
-                cube_edge_points[cube_edge_index] = I1.position + (isovalue - I1.density) * (I2.position - I1.position) / denominator;
+                cube_edge_points[cube_edge_index] = I1.position + (threshold - I1.density) * (I2.position - I1.position) / denominator;
             }
 
             cube_edge_bits = cube_edge_bits >> 1;
@@ -244,6 +984,17 @@ namespace mbl {
         const LerpedEdgePoints& leps, 
         OutVertices& out_vertices, 
         OutIndices& out_indices
+    ) {
+        return build_cube_tris(cube_bits, leps, out_vertices, out_indices, (int32_t) mesh_data.indices.size());
+    }
+
+    template <typename M>
+    CubeTriData MetaballEngine<M>::build_cube_tris(
+        const uint8_t cube_bits, 
+        const LerpedEdgePoints& leps, 
+        OutVertices& out_vertices, 
+        OutIndices& out_indices,
+        const int32_t index_offset
     ) {
         const int32_t (&edge_ordering)[16] = triTable[cube_bits];
         int32_t eoi = 0;
@@ -260,7 +1011,7 @@ namespace mbl {
             out_vertices[eoi + 2].normal = compute_normal(out_vertices[eoi+2].position); 
 
             // Setting Index Data
-            int32_t index_at = eoi + (int32_t) mesh_data.indices.size();
+            int32_t index_at = eoi + index_offset;
             out_indices[eoi] = index_at;
             out_indices[eoi + 1] = index_at + 1;
             out_indices[eoi + 2] = index_at + 2;
@@ -276,38 +1027,414 @@ namespace mbl {
     }
 
     template <typename M>
-    const common::graphics::MeshData& MetaballEngine<M>::construct_mesh() {
-        if (!is_dirty) {
-            return mesh_data;
+    void MetaballEngine<M>::march_cube(
+        const uint8_t cube_bits, 
+        const CubeOrderedIsopoints& cube_isopoints, 
+        const float threshold, 
+        common::graphics::MeshData& out, 
+        MarchScratch& scratch
+    ) {
+        const int16_t cube_edge_bits = edge_table[cube_bits];
+        const LerpedEdgePoints& leps = lerp_cube_edges(cube_edge_bits, scratch.lerped_edge_points, cube_isopoints, threshold);
+        const CubeTriData tri_data = build_cube_tris(cube_bits, leps, scratch.cube_out_vertices, scratch.cube_out_indices, (int32_t) out.indices.size());
+
+        std::copy(tri_data.vertices.begin(), tri_data.vertices.begin() + tri_data.end_index, std::back_inserter(out.vertices));
+        std::copy(tri_data.indices.begin(), tri_data.indices.begin() + tri_data.end_index, std::back_inserter(out.indices));
+    }
+
+    template <typename M>
+    float MetaballEngine<M>::lazy_density(const int32_t node) {
+        float& density = field.get_density(node);
+        if (!test_bit(known_nodes, node)) {
+            set_bit(known_nodes, node);
+            known_node_list.push_back(node);
+            density = sum_metaballs(field.get_position(node));
         }
+        return density;
+    }
 
-        is_dirty = false;
-        const int32_t valid_points = update_densities().num_valid_points;
-        
-        mesh_data.vertices.clear();
-        mesh_data.vertices.reserve(valid_points);
-        mesh_data.indices.clear();
-        mesh_data.indices.reserve(valid_points);
+    template <typename M>
+    void MetaballEngine<M>::begin_sparse_extraction() {
+        field_dirty = false;
+        densities_complete = false;
+        layers_dirty = true;
+        occupancy.invalidate();
+
+        const size_t nodes = field.indices();
+        reset_bits(known_nodes, known_node_list, nodes);
+        reset_bits(visited_cells, visited_cell_list, nodes);
+        active_cells.clear();
+        prepare_mesh_data();
+    }
+
+    template <typename M>
+    void MetaballEngine<M>::flood_fill_from(const int32_t cell, CubeOrderedIsopoints& cube_isopoints, MarchScratch& scratch) {
+        // Corner masks of the faces shared with the -x, +x, -y, +y, -z & +z neighbors (see `cube_index_offsets`)
+        static constexpr uint8_t face_masks[6] = { 0x99, 0x66, 0x33, 0xCC, 0x0F, 0xF0 };
+
+        const IndexDim n = field.shape();       // nodes per axis
+        const IndexDim cells = n - 1;           // cells per axis
+        const int32_t strides[3] = { 1, n.x, n.x * n.y };
+
+        if (test_bit(visited_cells, cell)) {
+            return;
+        }
+        set_bit(visited_cells, cell);
+        visited_cell_list.push_back(cell);
+        cell_stack.push_back(cell);
+
+        while (!cell_stack.empty()) {
+            const int32_t at = cell_stack.back();
+            cell_stack.pop_back();
+
+            uint8_t cube_bits = 0;
+            for (uint8_t c = 0; c < 8; c++) {
+                const IndexDim& offset = cube_index_offsets[c];
+                const int32_t node = at + offset.x * strides[0] + offset.y * strides[1] + offset.z * strides[2];
+                cube_bits = cube_bits | ((uint8_t) (lazy_density(node) >= isovalue) << c);
+                cube_isopoints[c] = &field.get(node);
+            }
+
+            if (cube_bits == 0x0 || cube_bits == 0xFF) {
+                continue;
+            }
+
+            march_cube(cube_bits, cube_isopoints, isovalue, mesh_data, scratch);
+            active_cells.push_back(at);
+
+            const int32_t coords[3] = { at % n.x, (at / n.x) % n.y, at / (n.x * n.y) };
+            for (int32_t face = 0; face < 6; face++) {
+                const uint8_t face_bits = cube_bits & face_masks[face];
+                if (face_bits == 0x0 || face_bits == face_masks[face]) {
+                    continue;   // the surface doesn't cross this face
+                }
+
+                const int32_t axis = face / 2;
+                const int32_t step = (face & 0x1) ? 1 : -1;
+                const int32_t neighbor_coord = coords[axis] + step;
+                const int32_t neighbor = at + step * strides[axis];
+                if (neighbor_coord < 0 || neighbor_coord >= cells[axis] || test_bit(visited_cells, neighbor)) {
+                    continue;
+                }
+
+                set_bit(visited_cells, neighbor);
+                visited_cell_list.push_back(neighbor);
+                cell_stack.push_back(neighbor);
+            }
+        }
+    }
+
+    template <typename M>
+    bool MetaballEngine<M>::can_track(int32_t& dilation) const {
+        if constexpr (!HasBoundingBox<M>::value) {
+            return false;
+        } else {
+            if (previous_active_cells.empty() || meshes_since_full_scan >= full_scan_interval || extracted_bounds.size() != balls.size()) {
+                return false;
+            }
+
+            // The surface is assumed to move no further than the metaball bounds did
+            float max_displacement = 0.f;
+            for (size_t i = 0; i < balls.size(); i++) {
+                const BoundingBox now = balls[i].get_bounding_box();
+                const glm::vec3 moved = glm::max(
+                    glm::abs(now.min_point - extracted_bounds[i].min_point),
+                    glm::abs(now.max_point - extracted_bounds[i].max_point)
+                );
+                max_displacement = std::max(max_displacement, std::max(moved.x, std::max(moved.y, moved.z)));
+            }
+
+            const glm::vec3 cell_size = field.cell_size();
+            dilation = (int32_t) std::ceil(max_displacement / std::min(cell_size.x, std::min(cell_size.y, cell_size.z)));
+            return dilation <= max_dilation;
+        }
+    }
+
+    template <typename M>
+    void MetaballEngine<M>::remember_bounds() {
+        if constexpr (HasBoundingBox<M>::value) {
+            extracted_bounds.resize(balls.size());
+            for (size_t i = 0; i < balls.size(); i++) {
+                extracted_bounds[i] = balls[i].get_bounding_box();
+            }
+        }
+    }
+
+    template <typename M>
+    void MetaballEngine<M>::fit_field() {
+        if constexpr (HasBoundingBox<M>::value) {
+            if (fit_cell_size <= 0.f || balls.empty()) {
+                return;
+            }
+
+            BoundingBox joined = balls[0].get_bounding_box();
+            for (size_t i = 1; i < balls.size(); i++) {
+                joined.join_mut(balls[i].get_bounding_box());
+            }
+
+            // NaNs fail the comparison too
+            const glm::vec3 low_cells = glm::floor((joined.min_point - fit_margin) / fit_cell_size);
+            const glm::vec3 high_cells = glm::ceil((joined.max_point + fit_margin) / fit_cell_size);
+            if (!glm::all(glm::lessThan(glm::abs(low_cells), glm::vec3(MAX_FIT_CELL))) || !glm::all(glm::lessThan(glm::abs(high_cells), glm::vec3(MAX_FIT_CELL)))) {
+                return;
+            }
+
+            // Too wide a box keeps the cells around its middle
+            const IndexDim widths = glm::max(IndexDim(high_cells) - IndexDim(low_cells), IndexDim(1));
+            const IndexDim partitions = glm::min(widths, IndexDim(fit_max_partitions));
+            const IndexDim low = IndexDim(low_cells) + (widths - partitions) / 2;
+            if (low == fit_low && partitions == fit_partitions) {
+                return;
+            }
+
+            // Same grid, shifted: the previous surface's cells keep their place in the world. Cells of
+            // the engine's original field don't line up with it & are dropped
+            const IndexDim old_nodes = fit_partitions + 1;
+            const IndexDim new_nodes = partitions + 1;
+            const IndexDim shift = fit_low - low;
+            size_t kept = 0;
+            if (fit_partitions == IndexDim(0)) {
+                previous_active_cells.clear();
+            }
+            for (const int32_t cell : previous_active_cells) {
+                const IndexDim at = IndexDim(cell % old_nodes.x, (cell / old_nodes.x) % old_nodes.y, cell / (old_nodes.x * old_nodes.y)) + shift;
+                if (glm::all(glm::greaterThanEqual(at, IndexDim(0))) && glm::all(glm::lessThan(at, partitions))) {
+                    previous_active_cells[kept++] = at.x + at.y * new_nodes.x + at.z * new_nodes.x * new_nodes.y;
+                }
+            }
+            previous_active_cells.resize(kept);
+
+            fit_low = low;
+            fit_partitions = partitions;
+            const glm::vec3 half_extents = glm::vec3(partitions) * fit_cell_size / 2.f;
+            field.reshape(glm::vec3(low) * fit_cell_size + half_extents, half_extents, partitions);
+
+            field_dirty = true;
+            densities_complete = false;
+            occupancy.invalidate();
+        }
+    }
+
+    template <typename M>
+    void MetaballEngine<M>::march_rows(const float* thresholds, common::graphics::MeshData* outs, const size_t layers, std::vector<int32_t>* crossed) {
+        assert(crossed == nullptr || layers == 1);
+        const IndexDim n = field.shape();
+        const IndexDim cells = n - 1;
+        const int32_t stride_y = n.x;
+        const int32_t stride_z = n.x * n.y;
+
+        int32_t corner_offsets[8];
+        for (uint8_t c = 0; c < 8; c++) {
+            const IndexDim& offset = cube_index_offsets[c];
+            corner_offsets[c] = offset.x + offset.y * stride_y + offset.z * stride_z;
+        }
 
         // Buffers we'll reuse multiple times in this loop
         CubeOrderedIsopoints ordered_iso_points = {};
-        LerpedEdgePoints lerped_edge_points = {};
-        OutVertices cube_out_vertices = {};
-        OutIndices cube_out_indices = {};
-        
-        for (CubeView cv : MarchingCubeRange(field)) {
-            const CubeBitsResult cbr = compute_cube_bits(cv, ordered_iso_points);
+        MarchScratch scratch;
+        IsoPoint* nodes = field.data();
+        row_cases.resize((size_t) cells.x * layers);
+        row_layers_crossed.resize(layers);
+
+        auto march_cell = [&](const size_t layer, const int32_t cell, const uint8_t cube_bits) {
+            for (uint8_t c = 0; c < 8; c++) {
+                ordered_iso_points[c] = nodes + cell + corner_offsets[c];
+            }
+
+            march_cube(cube_bits, ordered_iso_points, thresholds[layer], outs[layer], scratch);
+            if (crossed != nullptr) {
+                crossed->push_back(cell);
+            }
+        };
+
+        // Case bytes come straight from the occupancy bits for a threshold they were built against,
+        // otherwise from the densities
+        for (int32_t z = 0; z < cells.z; z++) {
+            for (int32_t y = 0; y < cells.y; y++) {
+                const int32_t row = y * stride_y + z * stride_z;
+                for (size_t layer = 0; layer < layers; layer++) {
+                    row_layers_crossed[layer] = !occupancy.built_for(thresholds[layer])
+                        && row_classifier.classify_row(nodes + row, n.x, stride_y, stride_z, thresholds[layer], row_cases.data() + layer * cells.x);
+                }
+
+                for (size_t layer = 0; layer < layers; layer++) {
+                    if (occupancy.built_for(thresholds[layer])) {
+                        occupancy.for_each_crossed_cell(y, z, [&](const int32_t x, const uint8_t cube_bits) { march_cell(layer, row + x, cube_bits); });
+                        continue;
+                    }
+                    if (!row_layers_crossed[layer]) {
+                        continue;
+                    }
+
+                    const uint8_t* cases = row_cases.data() + layer * cells.x;
+                    for (int32_t x = 0; x < cells.x; x++) {
+                        if (cases[x] != 0x0 && cases[x] != 0xFF) {
+                            march_cell(layer, row + x, cases[x]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    template <typename M>
+    void MetaballEngine<M>::full_scan() {
+        if (field_dirty || !densities_complete) {
+            update_densities();
+        } else if (!occupancy.built_for(isovalue)) {
+            occupancy.build(field, isovalue);
+            num_valid_points = (int32_t) occupancy.count();
+        }
+
+        const bool record_active = extraction_mode == ExtractionMode::Tracking;
+        active_cells.clear();
+        prepare_mesh_data();
+        auto normal_of = [this](const glm::vec3& p) { return compute_normal(p); };
+        if (extraction_backend == ExtractionBackend::FlyingEdges && !record_active) {
+            flying_edges.extract(field, occupancy, isovalue, normal_of, mesh_data);
+        } else if (extraction_backend == ExtractionBackend::SurfaceNets && !record_active) {
+            surface_nets.extract(field, occupancy, isovalue, normal_of, mesh_data);
+        } else {
+            march_rows(&isovalue, &mesh_data, 1, record_active ? &active_cells : nullptr);
+        }
+
+        const IndexDim cells = field.shape() - 1;
+        extraction_stats = ExtractionStats { true, (size_t) cells.x * cells.y * cells.z, field.indices() };
+    }
+
+    template <typename M>
+    void MetaballEngine<M>::track_surface(const int32_t dilation) {
+        begin_sparse_extraction();
+
+        CubeOrderedIsopoints ordered_iso_points = {};
+        MarchScratch scratch;
 
-            if (cbr.cube_bits != 0x0 && cbr.cube_bits != 0xFF) {
-                const int16_t cube_edge_bits = edge_table[cbr.cube_bits];
-                const LerpedEdgePoints& leps = lerp_cube_edges(cube_edge_bits, lerped_edge_points, cbr.cube_isopoints);
-                const CubeTriData tri_data = build_cube_tris(cbr.cube_bits, leps, cube_out_vertices, cube_out_indices);
+        const IndexDim n = field.shape();
+        const IndexDim cells = n - 1;
+        for (const int32_t seed : previous_active_cells) {
+            const IndexDim at = IndexDim(seed % n.x, (seed / n.x) % n.y, seed / (n.x * n.y));
+            const IndexDim low = glm::max(at - dilation, IndexDim(0));
+            const IndexDim high = glm::min(at + dilation, cells - 1);
 
-                std::copy(tri_data.vertices.begin(), tri_data.vertices.begin() + tri_data.end_index, std::back_inserter(mesh_data.vertices));
-                std::copy(tri_data.indices.begin(), tri_data.indices.begin() + tri_data.end_index, std::back_inserter(mesh_data.indices));
+            for (int32_t z = low.z; z <= high.z; z++) {
+                for (int32_t y = low.y; y <= high.y; y++) {
+                    for (int32_t x = low.x; x <= high.x; x++) {
+                        flood_fill_from(x + y * n.x + z * n.x * n.y, ordered_iso_points, scratch);
+                    }
+                }
             }
         }
 
+        extraction_stats = ExtractionStats { false, visited_cell_list.size(), known_node_list.size() };
+    }
+
+    template <typename M>
+    void MetaballEngine<M>::seed_from_centers() {
+        begin_sparse_extraction();
+
+        CubeOrderedIsopoints ordered_iso_points = {};
+        MarchScratch scratch;
+
+        const IndexDim n = field.shape();
+        const IndexDim cells = n - 1;
+        const glm::vec3 cell_size = field.cell_size();
+        const glm::vec3 field_min = field.min_corner();
+
+        for (const M& ball : balls) {
+            const BoundingBox box = ball.get_bounding_box();
+            const glm::vec3 center = (box.min_point + box.max_point) / 2.f;
+            const IndexDim at = glm::clamp(IndexDim(glm::floor((center - field_min) / cell_size)), IndexDim(0), cells - 1);
+
+            // Walk along +x until the surface is found. Reaching a visited cell means an earlier walk or
+            // fill already went this way, so whatever surface lies ahead has been found
+            for (int32_t x = at.x; x < cells.x; x++) {
+                const int32_t cell = x + at.y * n.x + at.z * n.x * n.y;
+                if (test_bit(visited_cells, cell)) {
+                    break;
+                }
+
+                const size_t active_before = active_cells.size();
+                flood_fill_from(cell, ordered_iso_points, scratch);
+                if (active_cells.size() != active_before) {
+                    break;
+                }
+            }
+        }
+
+        extraction_stats = ExtractionStats { false, visited_cell_list.size(), known_node_list.size() };
+    }
+
+    template <typename M>
+    const common::graphics::MeshData& MetaballEngine<M>::construct_mesh() {
+        const bool isovalue_changed = !field_dirty && threshold_dirty;
+        if (!field_dirty && !threshold_dirty) {
+            return mesh_data;
+        }
+
+        if (field_dirty) {
+            fit_field();
+        }
+
+        int32_t dilation = 0;
+        if (extraction_mode == ExtractionMode::Seeded && HasBoundingBox<M>::value) {
+            if constexpr (HasBoundingBox<M>::value) {
+                seed_from_centers();
+            }
+        } else if (extraction_mode == ExtractionMode::Tracking && !isovalue_changed && can_track(dilation)) {
+            track_surface(dilation);
+            meshes_since_full_scan += 1;
+        } else {
+            full_scan();
+            meshes_since_full_scan = 0;
+        }
+
+        if (extraction_mode == ExtractionMode::Tracking) {
+            std::swap(previous_active_cells, active_cells);
+            remember_bounds();
+        }
+
+        update_mesh_estimates();
+        threshold_dirty = false;
+        mesh_revision += 1;
         return mesh_data;
     }
+
+    template <typename M>
+    template <typename N>
+    const common::graphics::CompactMeshData<N>& MetaballEngine<M>::construct_mesh(common::graphics::CompactMeshData<N>& out) {
+        const common::graphics::MeshData& mesh = construct_mesh();
+        if (out.revision == mesh_revision) {
+            return out;
+        }
+
+        const glm::vec3 bounds_size = 2.f * field.half_extents();
+        const glm::vec3 bounds_min = field.min_corner();
+        common::graphics::encode_compact_mesh(mesh, bounds_min, bounds_size, out);
+        out.revision = mesh_revision;
+        return out;
+    }
+
+    template <typename M>
+    const std::vector<common::graphics::MeshData>& MetaballEngine<M>::construct_meshes(const std::vector<float>& isovalues) {
+        if (field_dirty) {
+            fit_field();
+        }
+
+        if (field_dirty || !densities_complete) {
+            update_densities();
+        } else if (!layers_dirty && isovalues == layer_isovalues) {
+            return layer_meshes;
+        }
+
+        layers_dirty = false;
+        layer_isovalues = isovalues;
+        layer_meshes.resize(isovalues.size());
+        for (common::graphics::MeshData& mesh : layer_meshes) {
+            mesh.vertices.clear();
+            mesh.indices.clear();
+        }
+        march_rows(layer_isovalues.data(), layer_meshes.data(), layer_meshes.size(), nullptr);
+
+        return layer_meshes;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <isosurface.hpp>
+#include <occupancy.hpp>
+#include <common/graphics.hpp>
+#include <common/thread_pool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace mbl {
+    #include "../MarchingCubes.hpp"
+
+    /** Flying Edges isosurface extraction (Schroeder, Maynard & Geveci, 2015) over an `IsoSurface`
+     * whose densities are all current, classified by an `OccupancyVolume` built against the same threshold.
+     *
+     * Works a row of nodes (all nodes sharing a y & z) at a time, in passes that never write to
+     * another row's data, so every pass is split by z slices across the shared `common::ThreadPool`:
+     * (1) find & count the x, y & z edge crossings each node row owns (a node owns its +x, +y & +z
+     *     edges), 64 nodes at a time from XORs of occupancy bits, & count the triangles of each cell row
+     * (2) prefix sum the counts into output offsets
+     * (3) interpolate every crossed edge exactly once into its own vertex slot
+     * (4) write each cell's triangles as indices into those shared vertices, found by ranking
+     *     crossings within their row
+     *
+     * Runs of uniform nodes are skipped a word at a time, so rows the surface misses cost a few
+     * popcounts. The result is an indexed, watertight mesh with the same triangles (& winding) the
+     * engine's per-cell marching cubes produces, but with every vertex shared by all triangles touching it. */
+    class FlyingEdges {
+        private:
+            /** Axis & position of each marching cubes edge (see `edge_mappings`) relative to its cell's
+             * lowest corner. X edges are identified by the (dy, dz) node row they lie in, Y edges by
+             * (dx, dz) & Z edges by (dx, dy). */
+            struct EdgeSlot {
+                uint8_t axis;
+                uint8_t a;
+                uint8_t b;
+            };
+            static constexpr EdgeSlot edge_slots[12] = {
+                { 0, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 }, { 1, 0, 0 },
+                { 0, 0, 1 }, { 1, 1, 1 }, { 0, 1, 1 }, { 1, 0, 1 },
+                { 2, 0, 0 }, { 2, 1, 0 }, { 2, 1, 1 }, { 2, 0, 1 }
+            };
+
+            /** Triangles per marching cubes case */
+            static constexpr std::array<uint8_t, 256> case_triangles = []() {
+                std::array<uint8_t, 256> counts = {};
+                for (int c = 0; c < 256; c++) {
+                    int e = 0;
+                    while (e < 16 && triTable[c][e] != -1) {
+                        e += 1;
+                    }
+                    counts[c] = (uint8_t) (e / 3);
+                }
+                return counts;
+            }();
+
+            /** Per node row: how many crossings it owns & where its output goes */
+            struct RowInfo {
+                int32_t counts[3] = {};     // crossed x, y & z edges owned
+                int32_t vertex_base = 0;    // first vertex of this row's x edges, then y, then z
+                int32_t triangles = 0;      // triangles of the cell row starting at this node row
+                int32_t triangle_base = 0;
+            };
+
+            std::vector<RowInfo> rows;      // per node row, indexed `y + z * n.y`
+            IndexDim n = IndexDim(0);       // nodes per axis
+            int32_t words = 0;              // occupancy words per row
+            uint32_t workers = 1;
+
+            // Below this many nodes a pass isn't worth a thread
+            static constexpr size_t MIN_NODES_PER_WORKER = 1 << 16;
+
+            /** Calls `f(z)` for every z in [0, slices), split into up to `workers` chunks on the shared pool */
+            template <typename F>
+            void for_each_slice(const int32_t slices, F&& f) const {
+                const size_t nodes = (size_t) slices * n.x * n.y;
+                const uint32_t chunks = (uint32_t) std::min<size_t>({ (size_t) workers, (size_t) slices, std::max<size_t>(nodes / MIN_NODES_PER_WORKER, 1) });
+                if (chunks <= 1) {
+                    for (int32_t z = 0; z < slices; z++) {
+                        f(z);
+                    }
+                    return;
+                }
+
+                common::ThreadPool::shared().parallel_for(0, slices, [&f](const int64_t low, const int64_t high) {
+                    for (int32_t z = (int32_t) low; z < (int32_t) high; z++) {
+                        f(z);
+                    }
+                }, (slices + chunks - 1) / chunks);
+            }
+
+            /** Bit i set if x edge `w * 64 + i` of the node row `bits` is crossed */
+            uint64_t x_crossings(const uint64_t* bits, const int32_t w) const {
+                const uint64_t next = w + 1 < words ? bits[w + 1] : 0;
+                const int32_t edges = n.x - 1 - w * 64;
+                const uint64_t valid = edges >= 64 ? ~uint64_t(0) : (uint64_t(1) << edges) - 1;
+                return (bits[w] ^ ((bits[w] >> 1) | (next << 63))) & valid;
+            }
+
+            /** Number of x edges before `x` crossed in the node row `bits` */
+            int32_t x_rank(const uint64_t* bits, const int32_t x) const {
+                int32_t rank = 0;
+                for (int32_t w = 0; w < x >> 6; w++) {
+                    rank += std::popcount(x_crossings(bits, w));
+                }
+                return rank + std::popcount(x_crossings(bits, x >> 6) & ((uint64_t(1) << (x & 63)) - 1));
+            }
+
+            /** Number of nodes before `x` that differ between the node rows `a` & `b` */
+            static int32_t pair_rank(const uint64_t* a, const uint64_t* b, const int32_t x) {
+                int32_t rank = 0;
+                for (int32_t w = 0; w < x >> 6; w++) {
+                    rank += std::popcount(a[w] ^ b[w]);
+                }
+                return rank + std::popcount((a[x >> 6] ^ b[x >> 6]) & ((uint64_t(1) << (x & 63)) - 1));
+            }
+
+            static glm::vec3 edge_vertex(const IsoSurface& field, const size_t from, const size_t to, const float threshold) {
+                const IsoPoint& p1 = field.data()[from];
+                const IsoPoint& p2 = field.data()[to];
+                return p1.position + (threshold - p1.density) * (p2.position - p1.position) / (p2.density - p1.density);
+            }
+
+            template <typename Density>
+            static glm::vec3 edge_vertex(const BasicIsoSurface<Density>& field, const size_t from, const size_t to, const float threshold) {
+                const glm::vec3 p1 = field.get_position((uint32_t) from);
+                const glm::vec3 p2 = field.get_position((uint32_t) to);
+                const float d1 = field.get_density((uint32_t) from);
+                return p1 + (threshold - d1) * (p2 - p1) / (field.get_density((uint32_t) to) - d1);
+            }
+
+        public:
+            /** Chunks each pass is split into on the shared `common::ThreadPool`, 1 to run on the calling
+             * thread alone. Small fields are never split. */
+            void set_workers(const uint32_t count) {
+                workers = std::max<uint32_t>(count, 1);
+            }
+
+            uint32_t get_workers() const {
+                return workers;
+            }
+
+            /** Extracts the `threshold` isosurface of `field` into `out` (cleared first). `occupancy` must have
+             * been built from `field` against `threshold`. `normal_of(position)` gives each vertex's normal &
+             * must be safe to call from several threads at once. Fields of quantized densities are read
+             * through their decoding accessors. */
+            template <typename Density, typename NormalFn>
+            void extract(const BasicIsoSurface<Density>& field, const OccupancyVolume& occupancy, const float threshold, NormalFn&& normal_of, common::graphics::MeshData& out) {
+                n = field.shape();
+                words = occupancy.row_words();
+                const IndexDim cells = n - 1;
+                const int32_t stride_y = n.x;
+                const int32_t stride_z = n.x * n.y;
+                rows.resize((size_t) n.y * n.z);
+
+                // (1) count crossings per node row & triangles per cell row
+                for_each_slice(n.z, [&](const int32_t z) {
+                    for (int32_t y = 0; y < n.y; y++) {
+                        RowInfo& row = rows[y + z * n.y];
+                        const uint64_t* bits = occupancy.row_bits(y, z);
+                        const uint64_t* above = y < cells.y ? occupancy.row_bits(y + 1, z) : nullptr;
+                        const uint64_t* behind = z < cells.z ? occupancy.row_bits(y, z + 1) : nullptr;
+
+                        row.counts[0] = row.counts[1] = row.counts[2] = 0;
+                        for (int32_t w = 0; w < words; w++) {
+                            row.counts[0] += std::popcount(x_crossings(bits, w));
+                            row.counts[1] += above != nullptr ? std::popcount(bits[w] ^ above[w]) : 0;
+                            row.counts[2] += behind != nullptr ? std::popcount(bits[w] ^ behind[w]) : 0;
+                        }
+
+                        row.triangles = 0;
+                        if (above != nullptr && behind != nullptr) {
+                            occupancy.for_each_crossed_cell(y, z, [&row](const int32_t, const uint8_t cube_bits) {
+                                row.triangles += case_triangles[cube_bits];
+                            });
+                        }
+                    }
+                });
+
+                // (2) offsets
+                int32_t vertex_count = 0;
+                int32_t triangle_count = 0;
+                for (RowInfo& row : rows) {
+                    row.vertex_base = vertex_count;
+                    row.triangle_base = triangle_count;
+                    vertex_count += row.counts[0] + row.counts[1] + row.counts[2];
+                    triangle_count += row.triangles;
+                }
+                out.vertices.resize((size_t) vertex_count);
+                out.indices.resize((size_t) triangle_count * 3);
+
+                // (3) vertices, each crossed edge interpolated once, in x order per axis
+                for_each_slice(n.z, [&](const int32_t z) {
+                    for (int32_t y = 0; y < n.y; y++) {
+                        const RowInfo& row = rows[y + z * n.y];
+                        const size_t start = (size_t) y * stride_y + (size_t) z * stride_z;
+                        const uint64_t* bits = occupancy.row_bits(y, z);
+                        common::graphics::Vertex* vertex = out.vertices.data() + row.vertex_base;
+
+                        // Emits every edge flagged in `crossed` (one word per 64 nodes) from node x to node x + `stride`
+                        auto emit_run = [&](auto crossed_word, const int32_t count, const int32_t stride) {
+                            if (count == 0) {
+                                return;
+                            }
+                            for (int32_t w = 0; w < words; w++) {
+                                uint64_t crossed = crossed_word(w);
+                                while (crossed != 0) {
+                                    const size_t from = start + (size_t) (w * 64 + std::countr_zero(crossed));
+                                    crossed &= crossed - 1;
+
+                                    const glm::vec3 position = edge_vertex(field, from, from + stride, threshold);
+                                    *vertex = common::graphics::Vertex { position, normal_of(position) };
+                                    vertex += 1;
+                                }
+                            }
+                        };
+
+                        emit_run([&](const int32_t w) { return x_crossings(bits, w); }, row.counts[0], 1);
+                        if (y < cells.y) {
+                            const uint64_t* above = occupancy.row_bits(y + 1, z);
+                            emit_run([&](const int32_t w) { return bits[w] ^ above[w]; }, row.counts[1], stride_y);
+                        }
+                        if (z < cells.z) {
+                            const uint64_t* behind = occupancy.row_bits(y, z + 1);
+                            emit_run([&](const int32_t w) { return bits[w] ^ behind[w]; }, row.counts[2], stride_z);
+                        }
+                    }
+                });
+
+                // (4) triangles
+                for_each_slice(cells.z, [&](const int32_t z) {
+                    for (int32_t y = 0; y < cells.y; y++) {
+                        const int32_t r = y + z * n.y;
+                        if (rows[r].triangles == 0) {
+                            continue;
+                        }
+
+                        // Node rows around the cell row, indexed dy + 2 dz
+                        const uint64_t* corner_bits[4] = {
+                            occupancy.row_bits(y, z), occupancy.row_bits(y + 1, z),
+                            occupancy.row_bits(y, z + 1), occupancy.row_bits(y + 1, z + 1)
+                        };
+                        const RowInfo* corner_rows[4] = { &rows[r], &rows[r + 1], &rows[r + n.y], &rows[r + n.y + 1] };
+                        int32_t* index = out.indices.data() + (size_t) rows[r].triangle_base * 3;
+
+                        occupancy.for_each_crossed_cell(y, z, [&](const int32_t x, const uint8_t cube_bits) {
+                            const int (&edges)[16] = triTable[cube_bits];
+                            for (int e = 0; e < 16 && edges[e] != -1; e++) {
+                                const EdgeSlot& slot = edge_slots[edges[e]];
+                                switch (slot.axis) {
+                                    case 0: {
+                                        const int32_t k = slot.a + 2 * slot.b;
+                                        *index = corner_rows[k]->vertex_base + x_rank(corner_bits[k], x);
+                                        break;
+                                    }
+                                    case 1: {
+                                        // y edges of node rows (y, z + dz)
+                                        const RowInfo& owner = *corner_rows[2 * slot.b];
+                                        *index = owner.vertex_base + owner.counts[0] + pair_rank(corner_bits[2 * slot.b], corner_bits[2 * slot.b + 1], x + slot.a);
+                                        break;
+                                    }
+                                    default: {
+                                        // z edges of node rows (y + dy, z)
+                                        const RowInfo& owner = *corner_rows[slot.b];
+                                        *index = owner.vertex_base + owner.counts[0] + owner.counts[1] + pair_rank(corner_bits[slot.b], corner_bits[slot.b + 2], x + slot.a);
+                                        break;
+                                    }
+                                }
+                                index += 1;
+                            }
+                        });
+                    }
+                });
+            }
+    };
+}
\ No newline at end of file
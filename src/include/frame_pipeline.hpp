@@ -0,0 +1,225 @@
+#pragma once
+
+// MBL
+#include <engine.hpp>
+#include <common/graphics.hpp>
+
+// STD
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace mbl {
+    /** Fixed capacity FIFO shared between two threads. `push` waits while the queue is full & `pop`
+     * waits while it is empty, so a fast producer can never run more than `capacity` items ahead. */
+    template <typename T>
+    class BoundedQueue {
+        private:
+            std::deque<T> items;
+            const size_t capacity;
+            bool closed = false;
+
+            std::mutex mutex;
+            std::condition_variable not_full;
+            std::condition_variable not_empty;
+        public:
+            explicit BoundedQueue(const size_t p_capacity) : capacity(std::max<size_t>(p_capacity, 1)) {}
+
+            /** Push `item`, waiting for room. Returns false if the queue was closed. */
+            bool push(T&& item) {
+                std::unique_lock<std::mutex> lock(mutex);
+                not_full.wait(lock, [this] { return closed || items.size() < capacity; });
+                if (closed) {
+                    return false;
+                }
+
+                items.push_back(std::move(item));
+                lock.unlock();
+                not_empty.notify_one();
+                return true;
+            }
+
+            /** Pop the oldest item, waiting for one. Returns std::nullopt once the queue is closed & drained. */
+            std::optional<T> pop() {
+                std::unique_lock<std::mutex> lock(mutex);
+                not_empty.wait(lock, [this] { return closed || !items.empty(); });
+                if (items.empty()) {
+                    return std::nullopt;
+                }
+
+                T item = std::move(items.front());
+                items.pop_front();
+                lock.unlock();
+                not_full.notify_one();
+                return item;
+            }
+
+            /** No more items will be pushed. Waiting pops drain what's left, waiting pushes fail. */
+            void close() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    closed = true;
+                }
+                not_full.notify_all();
+                not_empty.notify_all();
+            }
+    };
+
+    /** Timing of a single pipeline stage, in milliseconds. */
+    struct StageStats {
+        uint64_t frames = 0;
+        double total_ms = 0.0;
+        double max_ms = 0.0;
+
+        void record(const double ms) {
+            frames += 1;
+            total_ms += ms;
+            max_ms = std::max(max_ms, ms);
+        }
+
+        double mean_ms() const {
+            return frames == 0 ? 0.0 : total_ms / (double) frames;
+        }
+    };
+
+    /** Timings reported by `FramePipeline::run`. `latency` is measured from the start of a frame's
+     * simulation to the end of its upload, so it includes time spent waiting in the queues. */
+    struct PipelineStats {
+        StageStats simulate;
+        StageStats extract;
+        StageStats upload;
+        StageStats latency;
+        double wall_ms = 0.0;
+
+        double frames_per_second() const {
+            return wall_ms <= 0.0 ? 0.0 : 1000.0 * (double) upload.frames / wall_ms;
+        }
+    };
+
+    /**
+     * Runs animated scenes as three overlapping stages, each on its own thread:
+     *
+     * (1) simulate: advances a copy of the metaballs & snapshots them
+     * (2) extract: swaps a snapshot into the engine & builds its mesh
+     * (3) upload: hands the finished mesh to a callback (a no-op by default, so the pipeline runs headless)
+     *
+     * Stages are connected by BoundedQueues, so while frame N is uploaded, frame N+1 is extracted & frame N+2
+     * simulated. Throughput is bounded by the slowest stage rather than the sum of all three.
+     *
+     * The upload callback runs on the upload thread. To upload to OpenGL from it, make a context
+     * current on that thread first.
+     *
+     * @code
+     * mbl::FramePipeline<M> pipeline(std::move(engine),
+     *     [](std::vector<M>& balls, uint64_t frame) { ...advance balls... });
+     * mbl::PipelineStats stats = pipeline.run(600);
+     * @endcode
+     * */
+    template <typename M = AggregateMetaball>
+    class FramePipeline {
+        public:
+            using Clock = std::chrono::steady_clock;
+            using Simulate = std::function<void(std::vector<M>& balls, uint64_t frame)>;
+            using Upload = std::function<void(const common::graphics::MeshData& mesh, uint64_t frame)>;
+
+        private:
+            struct SimulatedFrame {
+                uint64_t frame;
+                Clock::time_point started;
+                std::vector<M> balls;
+            };
+
+            struct ExtractedFrame {
+                uint64_t frame;
+                Clock::time_point started;
+                common::graphics::MeshData mesh;
+            };
+
+            MetaballEngine<M> engine;
+            std::vector<M> scene;
+            Simulate simulate;
+            Upload upload;
+            const size_t queue_capacity;
+
+            static double ms_since(const Clock::time_point start) {
+                return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            }
+
+        public:
+            /** Creates a pipeline over `p_engine`, whose current metaballs are the initial scene. Up to
+             * `p_queue_capacity` frames may wait between two stages. */
+            FramePipeline(MetaballEngine<M>&& p_engine, Simulate p_simulate, Upload p_upload = {}, const size_t p_queue_capacity = 1)
+                : engine(std::move(p_engine)),
+                  scene(engine.get_metaballs()),
+                  simulate(std::move(p_simulate)),
+                  upload(std::move(p_upload)),
+                  queue_capacity(p_queue_capacity) {}
+
+            /** Pushes `frames` frames through all three stages & returns once the last one is uploaded. */
+            PipelineStats run(const uint64_t frames) {
+                PipelineStats stats;
+                BoundedQueue<SimulatedFrame> simulated(queue_capacity);
+                BoundedQueue<ExtractedFrame> extracted(queue_capacity);
+                const Clock::time_point run_start = Clock::now();
+
+                std::thread simulate_thread([&] {
+                    for (uint64_t frame = 0; frame < frames; frame++) {
+                        const Clock::time_point started = Clock::now();
+                        if (simulate) {
+                            simulate(scene, frame);
+                        }
+                        SimulatedFrame snapshot { frame, started, scene };
+                        stats.simulate.record(ms_since(started));
+
+                        if (!simulated.push(std::move(snapshot))) {
+                            break;
+                        }
+                    }
+                    simulated.close();
+                });
+
+                std::thread extract_thread([&] {
+                    while (std::optional<SimulatedFrame> in = simulated.pop()) {
+                        const Clock::time_point started = Clock::now();
+                        engine.swap_metaballs(in->balls);
+                        ExtractedFrame out { in->frame, in->started, engine.construct_mesh() };
+                        stats.extract.record(ms_since(started));
+
+                        if (!extracted.push(std::move(out))) {
+                            break;
+                        }
+                    }
+                    extracted.close();
+                });
+
+                std::thread upload_thread([&] {
+                    while (std::optional<ExtractedFrame> in = extracted.pop()) {
+                        const Clock::time_point started = Clock::now();
+                        if (upload) {
+                            upload(in->mesh, in->frame);
+                        }
+                        stats.upload.record(ms_since(started));
+                        stats.latency.record(ms_since(in->started));
+                    }
+                });
+
+                simulate_thread.join();
+                extract_thread.join();
+                upload_thread.join();
+
+                stats.wall_ms = ms_since(run_start);
+                return stats;
+            }
+
+            /** The simulated scene, as of the last frame run */
+            const std::vector<M>& get_scene() const {
+                return scene;
+            }
+    };
+}
\ No newline at end of file
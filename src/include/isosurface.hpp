@@ -24,34 +24,67 @@ namespace mbl {
 
     typedef glm::ivec3 IndexDim;
 
+    /** Order the points of an IsoSurface are stored in */
+    enum class NodeLayout {
+        /** x fastest, then y, then z. Rows of points are contiguous, which the row based passes
+         * (occupancy, scanline & Flying Edges, Surface Nets) rely on. */
+        Linear,
+        /** 4x4x4 bricks of points, x fastest within & across bricks. A cell's 8 corners mostly share
+         * one brick (1 KiB), so cell-at-a-time gathers walking brick by brick stay in cache. Axes
+         * are padded to whole bricks. */
+        Bricked
+    };
+
     /** Struct for mapping between linear indices & 3d indices
-     * indices. Takes in an `IndexDim` "dim" as a context. */
+     * indices. Takes in an `IndexDim` "dim" as a context, & the `NodeLayout` indices follow. */
     struct IndexCompactor {
+        static constexpr int32_t BRICK_SHIFT = 2;   // bricks are 2^BRICK_SHIFT points a side
+        static constexpr int32_t BRICK_MASK = (1 << BRICK_SHIFT) - 1;
+
         const IndexDim dim;
+        const NodeLayout layout = NodeLayout::Linear;
 
-        IndexCompactor(const IndexDim& dim) : dim(dim) {}
+        IndexCompactor(const IndexDim& dim, const NodeLayout layout = NodeLayout::Linear) : dim(dim), layout(layout) {}
         IndexCompactor(int32_t x, int32_t y, int32_t z) : dim(IndexDim(x,y,z)) {}
         IndexCompactor(int32_t x) : dim(IndexDim(x,x,x)) {}
 
         int32_t flatten(int32_t x, int32_t y, int32_t z) const;
+        /** Part of `flatten` contributed by coordinate `value` on `axis`, the sum over the 3 axes
+         * being the flattened index */
         int32_t flatten_at(int32_t value, int32_t axis) const;
         IndexDim unflatten(int32_t i) const;
 
+        /** Number of slots indices are flattened into, counting the padding of bricked layouts */
+        size_t size() const;
+
         const IndexDim& dimensions() const;
     };
     
-    /** Cube shaped IsoSurface with side lengths 'length' is created, centered
-     * on position 'center'. */
-    class IsoSurface {
+    /** Box shaped scalar field whose node densities are stored as `Density`. `float` (`IsoSurface`)
+     * stores whole `IsoPoint`s & is what the engine's passes work on. The 16 bit storages of
+     * `quantized_isosurface.hpp` store densities alone, for fields too large to hold as `IsoPoint`s. */
+    template <typename Density = float>
+    class BasicIsoSurface;
+
+    using IsoSurface = BasicIsoSurface<float>;
+
+    /** Box shaped IsoSurface centered on position 'center', spanning 'half_extents' either side of
+     * it along each axis, split into 'partitions' cells along each axis. Cubes are the common case. */
+    template <>
+    class BasicIsoSurface<float> {
     private:
-        float m_side_length;
-        uint32_t m_partitions;
+        glm::vec3 m_half_extents;
+        IndexDim m_partitions;
         glm::vec3 m_center_position;
+        NodeLayout m_layout;
         std::vector<IsoPoint> m_isopoints;
 
-        IsoSurface(const glm::vec3& center, float length, uint32_t partitions);
+        BasicIsoSurface(const glm::vec3& center, const glm::vec3& half_extents, const IndexDim& partitions, NodeLayout layout = NodeLayout::Linear);
+
+        /** Lays out the positions of every point for the current center, extents & partitions */
+        void place_points();
     public:
-        ~IsoSurface() = default;
+        ~BasicIsoSurface() = default;
 
         std::vector<IsoPoint>& isopoints();
         const std::vector<IsoPoint>& isopoints() const;
@@ -80,14 +113,41 @@ namespace mbl {
             uint32_t partitions
         );
 
+        /** Initializes a box shaped IsoSurface centered at position 'center', spanning 'half_extents'
+         * either side of it, with 'partitions' (at least 1) partitions along each axis, its points
+         * stored in 'layout' order. Padding points of a bricked layout sit at the origin. */
+        static IsoSurface construct(
+            const glm::vec3& center,
+            const glm::vec3& half_extents,
+            const IndexDim& partitions,
+            NodeLayout layout = NodeLayout::Linear
+        );
+
+        /** Moves & resizes this IsoSurface as if it were constructed again with these arguments. Every
+         * density is reset to 0. The point storage is reused whenever it's large enough. */
+        void reshape(const glm::vec3& center, const glm::vec3& half_extents, const IndexDim& partitions);
+
+        /** Initializes a coarser IsoSurface over the same cube as 'fine', holding every 'step'th point
+         * of 'fine' along each axis (positions & densities). 'step' must divide every axis' partitions of 'fine'.
+         * The coarse IsoSurface is always linear. */
+        static IsoSurface subsample(const IsoSurface& fine, uint32_t step);
+
+        /** Copies the densities of every 'step'th point of 'fine' into this IsoSurface, which must
+         * have been subsampled from 'fine' with the same 'step'. 'fine' must be linear. */
+        void resample(const IsoSurface& fine, uint32_t step);
+
         IsoPoint* data();
         const IsoPoint* data() const;
         
         /** Returns an IndexCompactor that uses
-         * the shape of the IsoSurface as a context */
+         * the shape & layout of the IsoSurface as a context */
         IndexCompactor compactor() const;
 
-        /** Returns the number of indices (or points) within the IsoSurface */
+        /** Returns the order points are stored in */
+        NodeLayout layout() const;
+
+        /** Returns the number of indices (or points) within the IsoSurface, counting the padding
+         * of bricked layouts */
         size_t indices() const;
 
         const glm::vec3& get_origin() const {
@@ -98,8 +158,18 @@ namespace mbl {
          * as an IndexDim */
         IndexDim shape() const;
 
-        /** Returns the side length of this IsoSurface */
+        /** Returns half the side length of this IsoSurface along x, which for a cube is
+         * every axis' (see `half_extents`) */
         float length() const;
+
+        /** Returns how far this IsoSurface reaches either side of its center along each axis */
+        const glm::vec3& half_extents() const;
+
+        /** Returns the corner of this IsoSurface with the smallest coordinates */
+        glm::vec3 min_corner() const;
+
+        /** Returns the side lengths of a single cell */
+        glm::vec3 cell_size() const;
         
         /** For debugging */
         void _print_positions() const {
@@ -0,0 +1,215 @@
+#pragma once
+
+// MBL
+#include <engine.hpp>
+#include <isosurface.hpp>
+#include <occupancy.hpp>
+#include <flying_edges.hpp>
+#include <common/graphics.hpp>
+
+// STD
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace mbl {
+    /** Meshes of one engine's field at several resolutions, picked per frame by distance from the camera.
+     *
+     * Level 0 is the engine's own mesh. Level k is extracted from a copy of the field holding every
+     * 2^k-th node along each axis, so each level has about a quarter of the triangles of the one before
+     * & no metaball is evaluated to build it. Coarse levels are extracted with Flying Edges, normals
+     * taken from the coarse field's own gradient, & cached until the field's densities or the
+     * isovalue change. A level only exists while 2^k divides the field's partitions along every axis.
+     * When the engine's field changes shape or bounds (e.g. under `set_auto_fit`), the levels are
+     * refitted to it, so the number of levels can change from frame to frame.
+     *
+     * Level k + 1 is used past `switch_distances[k]` from the field's box. To keep a camera sitting on
+     * a boundary from flickering between levels, switching coarser waits until the distance is
+     * `hysteresis` (a fraction) past the boundary & switching finer until it's that far inside.
+     *
+     * @code
+     * mbl::LodMeshSet<M> lods(engine);
+     * // each frame
+     * const mbl::common::graphics::MeshData& mesh = lods.mesh_for(engine, camera.position);
+     * @endcode
+     * */
+    template <typename M = AggregateMetaball>
+    class LodMeshSet {
+        private:
+            struct Level {
+                uint32_t step;
+                IsoSurface field;
+                OccupancyVolume occupancy;
+                common::graphics::MeshData mesh;
+                uint64_t field_revision = 0;    // engine field revision the mesh was extracted from, 0 if never
+
+                Level(const uint32_t p_step, IsoSurface&& p_field) : step(p_step), field(std::move(p_field)) {}
+            };
+
+            std::vector<Level> levels;          // coarse levels, levels[k - 1] is level k
+            size_t max_levels;
+            std::vector<float> switch_distances;
+            float hysteresis;
+            size_t current = 0;
+            FlyingEdges extractor;
+
+            // shape & bounds of the engine field the levels were fitted to
+            IndexDim fine_shape = IndexDim(0);
+            glm::vec3 fine_origin = glm::vec3(0.f);
+            glm::vec3 fine_half_extents = glm::vec3(0.f);
+
+            bool fitted_to(const IsoSurface& fine) const {
+                return fine.shape() == fine_shape && fine.get_origin() == fine_origin && fine.half_extents() == fine_half_extents;
+            }
+
+            /** Fits the coarse levels to `fine`'s shape & bounds. Levels that still divide it keep their
+             * storage, their meshes are re-extracted on next use. */
+            void fit_levels(const IsoSurface& fine) {
+                const IndexDim partitions = fine.shape() - 1;
+                const auto divides = [&partitions](const int32_t step) {
+                    return glm::all(glm::equal(partitions % step, IndexDim(0))) && glm::all(glm::greaterThanEqual(partitions / step, IndexDim(2)));
+                };
+
+                size_t count = 0;
+                for (uint32_t step = 2; count + 1 < max_levels && divides((int32_t) step); step *= 2, count++) {
+                    if (count < levels.size()) {
+                        levels[count].field.reshape(fine.get_origin(), fine.half_extents(), partitions / (int32_t) step);
+                        levels[count].occupancy.invalidate();
+                        levels[count].field_revision = 0;
+                    } else {
+                        levels.emplace_back(step, IsoSurface::subsample(fine, step));
+                    }
+                }
+                levels.erase(levels.begin() + (std::ptrdiff_t) count, levels.end());
+                current = std::min(current, levels.size());
+
+                fine_shape = fine.shape();
+                fine_origin = fine.get_origin();
+                fine_half_extents = fine.half_extents();
+            }
+
+            /** Normal at `position` on a vertex of `field`'s mesh, from the central difference gradients
+             * of the surrounding nodes blended trilinearly */
+            static glm::vec3 field_normal(const IsoSurface& field, const glm::vec3& position) {
+                const glm::ivec3 n = field.shape();
+                const glm::vec3 t = glm::clamp((position - field.min_corner()) / field.cell_size(), glm::vec3(0.f), glm::vec3(n - 1));
+                const glm::ivec3 cell = glm::min(glm::ivec3(t), n - 2);
+                const glm::vec3 f = t - glm::vec3(cell);
+
+                const IsoPoint* nodes = field.data();
+                auto density = [&](const glm::ivec3& i) {
+                    const glm::ivec3 c = glm::clamp(i, glm::ivec3(0), n - 1);
+                    return nodes[c.x + (size_t) c.y * n.x + (size_t) c.z * n.x * n.y].density;
+                };
+
+                glm::vec3 gradient = glm::vec3(0.f);
+                for (int32_t corner = 0; corner < 8; corner++) {
+                    const glm::ivec3 o = glm::ivec3(corner & 1, (corner >> 1) & 1, corner >> 2);
+                    const glm::ivec3 i = cell + o;
+                    const glm::vec3 w = glm::mix(glm::vec3(1.f) - f, f, glm::vec3(o));
+                    const glm::vec3 g = glm::vec3(
+                        density(i + glm::ivec3(1, 0, 0)) - density(i - glm::ivec3(1, 0, 0)),
+                        density(i + glm::ivec3(0, 1, 0)) - density(i - glm::ivec3(0, 1, 0)),
+                        density(i + glm::ivec3(0, 0, 1)) - density(i - glm::ivec3(0, 0, 1))
+                    );
+
+                    // A node landing on a metaball's center can hold an infinite density, leave it out
+                    if (std::isfinite(g.x) && std::isfinite(g.y) && std::isfinite(g.z)) {
+                        gradient += (w.x * w.y * w.z) * g;
+                    }
+                }
+                return glm::length(gradient) > 0.f ? -glm::normalize(gradient) : glm::vec3(0.f);
+            }
+
+        public:
+            /** Sets up to `level_count` levels (including level 0) for `engine`'s field. Level k + 1 is
+             * used past 2^(k + 1) of the field's longest side lengths from the field, see `set_switch_distances`. */
+            explicit LodMeshSet(const MetaballEngine<M>& engine, const size_t level_count = 3, const float p_hysteresis = 0.1f)
+                : max_levels(std::max<size_t>(level_count, 1)), hysteresis(p_hysteresis) {
+                const IsoSurface& fine = engine.get_field();
+                fit_levels(fine);
+
+                const glm::vec3 extents = fine.half_extents();
+                const float side = 2.f * std::max(extents.x, std::max(extents.y, extents.z));
+                for (size_t k = 0; k + 1 < max_levels; k++) {
+                    switch_distances.push_back(side * (float) (2u << k));
+                }
+            }
+
+            /** Distances from the field's box past which each coarser level is used, one per level after
+             * level 0 (up to the `level_count` the set was made with), increasing */
+            LodMeshSet<M>& set_switch_distances(const std::vector<float>& distances) {
+                switch_distances = distances;
+                switch_distances.resize(max_levels - 1, std::numeric_limits<float>::infinity());
+                return *this;
+            }
+
+            /** Number of levels the engine's field currently allows, including level 0 */
+            size_t level_count() const {
+                return levels.size() + 1;
+            }
+
+            /** Every how many fine nodes level `level` samples along each axis */
+            uint32_t step_of(const size_t level) const {
+                return level == 0 ? 1 : levels[level - 1].step;
+            }
+
+            /** Level picked by the last `select` */
+            size_t current_level() const {
+                return current;
+            }
+
+            /** Picks the level for a camera at `camera_position`, with hysteresis around the last pick */
+            size_t select(const MetaballEngine<M>& engine, const glm::vec3& camera_position) {
+                const IsoSurface& field = engine.get_field();
+                const glm::vec3 offset = glm::max(glm::abs(camera_position - field.get_origin()) - field.half_extents(), glm::vec3(0.f));
+                const float distance = glm::length(offset);
+
+                while (current < levels.size() && distance > switch_distances[current] * (1.f + hysteresis)) {
+                    current += 1;
+                }
+                while (current > 0 && distance < switch_distances[current - 1] * (1.f - hysteresis)) {
+                    current -= 1;
+                }
+                return current;
+            }
+
+            /** Mesh of `level`, re-extracted only if `engine`'s densities or isovalue changed since. Levels
+             * past the coarsest the field currently allows give the coarsest. */
+            const common::graphics::MeshData& mesh(MetaballEngine<M>& engine, const size_t level) {
+                if (level == 0) {
+                    return engine.construct_mesh();
+                }
+
+                const IsoSurface& fine = engine.get_complete_field();
+                if (!fitted_to(fine)) {
+                    fit_levels(fine);
+                }
+                if (levels.empty()) {
+                    return engine.construct_mesh();
+                }
+
+                Level& l = levels[std::min(level, levels.size()) - 1];
+                if (l.field_revision != engine.get_field_revision()) {
+                    l.field.resample(fine, l.step);
+                    l.occupancy.invalidate();
+                    l.field_revision = engine.get_field_revision();
+                }
+
+                const float isovalue = engine.get_isovalue();
+                if (!l.occupancy.built_for(isovalue)) {
+                    l.occupancy.build(l.field, isovalue);
+                    const IsoSurface& coarse = l.field;
+                    extractor.extract(coarse, l.occupancy, isovalue, [&coarse](const glm::vec3& p) { return field_normal(coarse, p); }, l.mesh);
+                }
+                return l.mesh;
+            }
+
+            /** Mesh of the level picked for a camera at `camera_position` */
+            const common::graphics::MeshData& mesh_for(MetaballEngine<M>& engine, const glm::vec3& camera_position) {
+                return mesh(engine, select(engine, camera_position));
+            }
+    };
+}
\ No newline at end of file
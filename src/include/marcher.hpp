@@ -54,7 +54,7 @@ namespace mbl {
                 }
 
                 IsoPoint& at(int i) {
-                    IndexDim idx(i % 2, i / 2, i / 4);
+                    IndexDim idx(i % 2, (i / 2) % 2, i / 4);
                     return at(idx.x, idx.y, idx.z);
                 }
             };
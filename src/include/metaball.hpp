@@ -58,6 +58,10 @@ namespace mbl {
         /** Expose the inner `T` powering this Metaball */
         T& unwrap() { return m_scalar_func; }
         const T& unwrap() const { return m_scalar_func;}
+        size_t separable_terms() const requires HasSeparableTerms<T>::value { return m_scalar_func.separable_terms(); }
+        void axis_factors(size_t axis, const float* coordinates, size_t n, float* factors) const requires HasSeparableTerms<T>::value {
+            m_scalar_func.axis_factors(axis, coordinates, n, factors);
+        }
     };
 
     template <typename T>
@@ -76,6 +80,11 @@ namespace mbl {
         T& unwrap() { return m_scalar_func; }
         const T& unwrap() const { return m_scalar_func;}
         BoundingBox get_bounding_box() const { return m_scalar_func.get_bounding_box(); }
+        float get_support_radius() const requires HasCompactSupport<T>::value { return m_scalar_func.get_support_radius(); }
+        size_t separable_terms() const requires HasSeparableTerms<T>::value { return m_scalar_func.separable_terms(); }
+        void axis_factors(size_t axis, const float* coordinates, size_t n, float* factors) const requires HasSeparableTerms<T>::value {
+            m_scalar_func.axis_factors(axis, coordinates, n, factors);
+        }
     };
 
     template <typename Derived>
@@ -32,6 +32,44 @@ namespace mbl {
             float operator()(float x, float y, float z) const {
                 return expf(-(x*x + y*y + z*z) / (2*variance));
             }
+
+            /** exp(-x^2 / 2v) * exp(-y^2 / 2v) * exp(-z^2 / 2v), a single term */
+            size_t separable_terms() const {
+                return 1;
+            }
+
+            void axis_factors(const size_t, const float* coordinates, const size_t n, float* factors) const {
+                for (size_t i = 0; i < n; i++) {
+                    factors[i] = expf(-(coordinates[i] * coordinates[i]) / (2*variance));
+                }
+            }
+        };
+
+        /** Gyroid-like surface, a1 sin(x)cos(y) + a2 sin(y)cos(z) + a3 sin(z)cos(x) */
+        struct Gyroid {
+            glm::vec3 m_weights = glm::vec3(1.f);
+
+            Gyroid(const glm::vec3& weights = glm::vec3(1.f)) : m_weights(weights) {}
+
+            float operator()(float x, float y, float z) const {
+                return m_weights.x * sinf(x) * cosf(y) + m_weights.y * sinf(y) * cosf(z) + m_weights.z * sinf(z) * cosf(x);
+            }
+
+            /** Term t is weighted sin along axis t, cos along the next axis & 1 along the last */
+            size_t separable_terms() const {
+                return 3;
+            }
+
+            void axis_factors(const size_t axis, const float* coordinates, const size_t n, float* factors) const {
+                for (size_t t = 0; t < 3; t++) {
+                    float* term = factors + t * n;
+                    for (size_t i = 0; i < n; i++) {
+                        term[i] = axis == t ? m_weights[(glm::length_t) t] * sinf(coordinates[i])
+                            : axis == (t + 1) % 3 ? cosf(coordinates[i])
+                            : 1.f;
+                    }
+                }
+            }
         };
 
         struct StickyPlane {
@@ -84,6 +122,74 @@ namespace mbl {
                 m_center = m_center + m_velocity * dt;
                 return m_center;
             }
+
+            /** Same heuristic box as `InverseSquareBlob`, lets engines see how far the blob moved */
+            BoundingBox get_bounding_box() const {
+                const glm::vec3 sqrt_of_scale_vec(sqrtf(m_scale));
+                return BoundingBox{ m_center + sqrt_of_scale_vec, m_center - sqrt_of_scale_vec };
+            }
+        };
+
+        /** Base for radial kernels with compact support: the kernel is a function of
+         * q = r^2 / R^2 that peaks at `m_scale` on the center and is exactly 0 for r >= R.
+         * `Derived` must implement `float falloff(float q) const` over q in [0, 1). */
+        template <typename Derived>
+        struct CompactRadialKernel {
+            glm::vec3 m_center = glm::vec3(0.f);
+            float m_radius = 1.f;
+            float m_scale = 1.f;
+
+            CompactRadialKernel(const glm::vec3& center, const float radius, const float scale) 
+                : m_center(center), m_radius(radius), m_scale(scale) {}
+
+            float operator()(float x, float y, float z) const {
+                const glm::vec3 d = m_center - glm::vec3(x, y, z);
+                const float q = glm::dot(d, d) / (m_radius * m_radius);
+                return q < 1.f ? m_scale * static_cast<const Derived&>(*this).falloff(q) : 0.f;
+            }
+
+            float get_support_radius() const {
+                return m_radius;
+            }
+
+            BoundingBox get_bounding_box() const {
+                const glm::vec3 radius_vec(m_radius);
+                return BoundingBox{ m_center + radius_vec, m_center - radius_vec };
+            }
+        };
+
+        /** (1 - r^2/R^2)^3 */
+        struct WyvillBlob : public CompactRadialKernel<WyvillBlob> {
+            WyvillBlob(const glm::vec3& center = glm::vec3(0.f), const float radius = 1.f, const float scale = 2.f) 
+                : CompactRadialKernel(center, radius, scale) {}
+
+            float falloff(const float q) const {
+                const float t = 1.f - q;
+                return t * t * t;
+            }
+        };
+
+        /** Wendland's C2 kernel, (1 - r/R)^4 * (4r/R + 1) */
+        struct WendlandBlob : public CompactRadialKernel<WendlandBlob> {
+            WendlandBlob(const glm::vec3& center = glm::vec3(0.f), const float radius = 1.f, const float scale = 2.f) 
+                : CompactRadialKernel(center, radius, scale) {}
+
+            float falloff(const float q) const {
+                const float r = sqrtf(q);
+                const float t = 1.f - r;
+                return (t * t) * (t * t) * (4.f * r + 1.f);
+            }
+        };
+
+        /** The Wyvill brothers' "soft objects" polynomial,
+         * 1 - (4/9)(r/R)^6 + (17/9)(r/R)^4 - (22/9)(r/R)^2 */
+        struct SoftObjectBlob : public CompactRadialKernel<SoftObjectBlob> {
+            SoftObjectBlob(const glm::vec3& center = glm::vec3(0.f), const float radius = 1.f, const float scale = 2.f) 
+                : CompactRadialKernel(center, radius, scale) {}
+
+            float falloff(const float q) const {
+                return 1.f + q * (-22.f / 9.f + q * (17.f / 9.f - q * (4.f / 9.f)));
+            }
         };
 
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <type_traits>
+#include <cstddef>
 #include <boundingbox.hpp>
 
 namespace mbl {
@@ -33,6 +34,70 @@ namespace mbl {
         : std::is_same<decltype(std::declval<const T>().get_bounding_box()), BoundingBox> {};
 
 
+    template <typename, typename = std::void_t<>>
+    struct HasCompactSupport : std::false_type {};
+
+    /** 
+     * Requirements for HasCompactSupport:
+     * 
+     * (1) Have the following function:
+     *      `float get_support_radius() const;`
+     *     where the scalar function is exactly 0 for every point further than the
+     *     returned radius from its center. Such types' bounding boxes are exact.
+     * 
+     * (2) That is all.
+     */
+    template <typename T>
+    struct HasCompactSupport<T, std::void_t<decltype(std::declval<const T>().get_support_radius())>> 
+        : std::is_same<decltype(std::declval<const T>().get_support_radius()), float> {};
+
+    template <typename, typename = std::void_t<>>
+    struct HasBatchCompute : std::false_type {};
+
+    /** 
+     * Requirements for HasBatchCompute:
+     * 
+     * (1) Have the following function:
+     *      `void compute_batch(const float* xs, const float* ys, const float* zs, float* out, size_t n) const;`
+     *     which ADDS the scalar function evaluated at the n points (xs[i], ys[i], zs[i]) onto out[i].
+     * 
+     * (2) That is all.
+     */
+    template <typename T>
+    struct HasBatchCompute<T, std::void_t<decltype(std::declval<const T>().compute_batch(
+        std::declval<const float*>(),
+        std::declval<const float*>(),
+        std::declval<const float*>(),
+        std::declval<float*>(),
+        std::declval<size_t>()
+    ))>> : std::true_type {};
+
+    template <typename, typename = std::void_t<>>
+    struct HasSeparableTerms : std::false_type {};
+
+    /** 
+     * Requirements for HasSeparableTerms:
+     * 
+     * (1) Have the following functions:
+     *      `size_t separable_terms() const;`
+     *      `void axis_factors(size_t axis, const float* coordinates, size_t n, float* factors) const;`
+     *     where the scalar function is a sum of `separable_terms()` products of one factor per axis,
+     *     f(x, y, z) = sum over t of X_t(x) * Y_t(y) * Z_t(z). `axis_factors` writes the factor of
+     *     term t along `axis` (0 = x, 1 = y, 2 = z) at each of the n coordinates onto factors[t * n + i].
+     * 
+     * (2) That is all.
+     */
+    template <typename T>
+    struct HasSeparableTerms<T, std::void_t<
+        decltype(std::declval<const T>().separable_terms()),
+        decltype(std::declval<const T>().axis_factors(
+            std::declval<size_t>(),
+            std::declval<const float*>(),
+            std::declval<size_t>(),
+            std::declval<float*>()
+        ))
+    >> : std::is_same<decltype(std::declval<const T>().separable_terms()), size_t> {};
+
     /** 
      * Requirements for being a BoundedScalarFunction
      * 
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <isosurface.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+namespace mbl {
+    /** One bit per field node, set if the node's density is >= the threshold it was built against.
+     * 32x smaller than the densities themselves, & enough on its own to classify cells.
+     *
+     * Bits are stored per node row (all nodes sharing a y & z), each row padded to whole 64 bit
+     * words, so bit x of row (y, z) is bit `x % 64` of word `(y + z * ny) * words_per_row + x / 64`. */
+    class OccupancyVolume {
+        private:
+            std::vector<uint64_t> words;
+            IndexDim dim = IndexDim(0);
+            int32_t words_per_row = 0;
+            float built_threshold = 0.f;
+            bool built = false;
+
+            static bool bit_of(const uint64_t word, const int32_t x) {
+                return (word >> x) & 0x1;
+            }
+
+            /** Crossed cells of word `w` of the cell row (y, z), also handing back the words of its four
+             * node rows (`low`) & the same shifted down a node (`high`) */
+            uint64_t crossed_cells(const int32_t y, const int32_t z, const int32_t w, uint64_t (&low)[4], uint64_t (&high)[4]) const {
+                const uint64_t* rows[4] = {
+                    words.data() + (size_t) (y + z * dim.y) * words_per_row,
+                    words.data() + (size_t) (y + 1 + z * dim.y) * words_per_row,
+                    words.data() + (size_t) (y + (z + 1) * dim.y) * words_per_row,
+                    words.data() + (size_t) (y + 1 + (z + 1) * dim.y) * words_per_row
+                };
+
+                uint64_t any = 0;
+                uint64_t all = ~uint64_t(0);
+                for (int32_t r = 0; r < 4; r++) {
+                    const uint64_t next = w + 1 < words_per_row ? rows[r][w + 1] : 0;
+                    low[r] = rows[r][w];
+                    high[r] = (low[r] >> 1) | (next << 63);
+                    any |= low[r] | high[r];
+                    all &= low[r] & high[r];
+                }
+
+                const int32_t remaining = dim.x - 1 - w * 64;
+                const uint64_t valid = remaining >= 64 ? ~uint64_t(0) : (uint64_t(1) << remaining) - 1;
+                return any & ~all & valid;
+            }
+
+            /** Clears every bit for a field of `shape` built against `threshold` */
+            void reset(const IndexDim& shape, const float threshold) {
+                dim = shape;
+                words_per_row = (dim.x + 63) / 64;
+                built_threshold = threshold;
+                built = true;
+                words.assign((size_t) words_per_row * dim.y * dim.z, 0);
+            }
+
+        public:
+            /** Sets one bit per node of `field` for density >= `threshold`. Reuses the last build's storage.
+             * `field` must be linear. */
+            void build(const IsoSurface& field, const float threshold) {
+                assert(field.layout() == NodeLayout::Linear);
+                reset(field.shape(), threshold);
+
+                const IsoPoint* nodes = field.data();
+                const int32_t rows = dim.y * dim.z;
+                for (int32_t r = 0; r < rows; r++) {
+                    const IsoPoint* row = nodes + (size_t) r * dim.x;
+                    uint64_t* out = words.data() + (size_t) r * words_per_row;
+
+                    int32_t x = 0;
+#if defined(__SSE2__)
+                    static_assert(sizeof(IsoPoint) == 4 * sizeof(float), "occupancy.hpp: IsoPoint is expected to be 4 packed floats.");
+                    const __m128 limit = _mm_set1_ps(threshold);
+                    const float* f = reinterpret_cast<const float*>(row);
+                    for (; x + 4 <= dim.x; x += 4) {
+                        // Pull the density (4th float) out of 4 consecutive IsoPoints
+                        const __m128 d01 = _mm_shuffle_ps(_mm_loadu_ps(f + 4 * x), _mm_loadu_ps(f + 4 * x + 4), _MM_SHUFFLE(3, 3, 3, 3));
+                        const __m128 d23 = _mm_shuffle_ps(_mm_loadu_ps(f + 4 * x + 8), _mm_loadu_ps(f + 4 * x + 12), _MM_SHUFFLE(3, 3, 3, 3));
+                        const __m128 d = _mm_shuffle_ps(d01, d23, _MM_SHUFFLE(2, 0, 2, 0));
+
+                        const uint64_t inside = (uint64_t) _mm_movemask_ps(_mm_cmpge_ps(d, limit));
+                        out[x >> 6] |= inside << (x & 63);
+                    }
+#endif
+                    for (; x < dim.x; x++) {
+                        out[x >> 6] |= (uint64_t) (row[x].density >= threshold) << (x & 63);
+                    }
+                }
+            }
+
+            /** Sets one bit per node of a field storing quantized densities. Against the reference they're
+             * stored relative to, nodes are classified straight from the stored values, otherwise each is
+             * decoded first. */
+            template <typename Density>
+            void build(const BasicIsoSurface<Density>& field, const float threshold) {
+                reset(field.shape(), threshold);
+
+                const bool at_reference = threshold == field.density_storage().reference;
+                const int32_t rows = dim.y * dim.z;
+                for (int32_t r = 0; r < rows; r++) {
+                    const uint32_t row = (uint32_t) r * dim.x;
+                    uint64_t* out = words.data() + (size_t) r * words_per_row;
+                    if (at_reference) {
+                        const auto* stored = field.data() + row;
+                        for (int32_t x = 0; x < dim.x; x++) {
+                            out[x >> 6] |= (uint64_t) Density::at_or_above_reference(stored[x]) << (x & 63);
+                        }
+                        continue;
+                    }
+
+                    for (int32_t x = 0; x < dim.x; x++) {
+                        out[x >> 6] |= (uint64_t) (field.get_density(row + x) >= threshold) << (x & 63);
+                    }
+                }
+            }
+
+            /** True if this was built against `threshold` (& hasn't been invalidated since) */
+            bool built_for(const float threshold) const {
+                return built && built_threshold == threshold;
+            }
+
+            /** Forget the last build, e.g. after the densities it was built from changed */
+            void invalidate() {
+                built = false;
+            }
+
+            /** Number of nodes at or above the threshold */
+            size_t count() const {
+                size_t total = 0;
+                for (const uint64_t word : words) {
+                    total += (size_t) std::popcount(word);
+                }
+                return total;
+            }
+
+            bool test(const int32_t x, const int32_t y, const int32_t z) const {
+                return bit_of(words[(size_t) (y + z * dim.y) * words_per_row + (x >> 6)], x & 63);
+            }
+
+            /** True if every node in the box from `low` to `high` (inclusive) is on the same side of the
+             * threshold, i.e. no cell inside the box is crossed by the surface */
+            bool uniform(const IndexDim& low, const IndexDim& high) const {
+                const bool first = test(low.x, low.y, low.z);
+                for (int32_t z = low.z; z <= high.z; z++) {
+                    for (int32_t y = low.y; y <= high.y; y++) {
+                        const uint64_t* row = words.data() + (size_t) (y + z * dim.y) * words_per_row;
+                        for (int32_t w = low.x >> 6; w <= high.x >> 6; w++) {
+                            const int32_t from = std::max(low.x - w * 64, 0);
+                            const int32_t to = std::min(high.x - w * 64, 63);
+                            const uint64_t mask = (~uint64_t(0) >> (63 - to)) & (~uint64_t(0) << from);
+                            if ((row[w] & mask) != (first ? mask : 0)) {
+                                return false;
+                            }
+                        }
+                    }
+                }
+                return true;
+            }
+
+            /** Bit i set if cell `w * 64 + i` of the cell row (y, z) is crossed by the surface */
+            uint64_t crossed_cells(const int32_t y, const int32_t z, const int32_t w) const {
+                uint64_t low[4];
+                uint64_t high[4];
+                return crossed_cells(y, z, w, low, high);
+            }
+
+            /** Calls `f(x, cube_bits)` for every cell of the cell row (y, z) the surface crosses, in
+             * increasing x. Case bytes are formed from the four node rows the cells span with shifts & ORs,
+             * 64 cells at a time; runs of uniform cells cost nothing. */
+            template <typename F>
+            void for_each_crossed_cell(const int32_t y, const int32_t z, F&& f) const {
+                // Pair (bit x, bit x + 1) of a row to case bits. Rows y+1 walk corners 3 -> 2 & 7 -> 6, so their pairs flip
+                static constexpr uint8_t flipped[4] = { 0x0, 0x2, 0x1, 0x3 };
+
+                const int32_t cells = dim.x - 1;
+                for (int32_t w = 0; w * 64 < cells; w++) {
+                    uint64_t low[4];    // bit i: node x = w * 64 + i of each node row, indexed dy + 2 dz
+                    uint64_t high[4];   // bit i: node x + 1
+                    uint64_t crossed = crossed_cells(y, z, w, low, high);
+                    while (crossed != 0) {
+                        const int32_t i = std::countr_zero(crossed);
+                        crossed &= crossed - 1;
+
+                        const uint8_t pair0 = (uint8_t) (bit_of(low[0], i) | (bit_of(high[0], i) << 1));
+                        const uint8_t pair1 = (uint8_t) (bit_of(low[1], i) | (bit_of(high[1], i) << 1));
+                        const uint8_t pair2 = (uint8_t) (bit_of(low[2], i) | (bit_of(high[2], i) << 1));
+                        const uint8_t pair3 = (uint8_t) (bit_of(low[3], i) | (bit_of(high[3], i) << 1));
+                        const uint8_t cube_bits = (uint8_t) (pair0 | (flipped[pair1] << 2) | (pair2 << 4) | (flipped[pair3] << 6));
+                        f(w * 64 + i, cube_bits);
+                    }
+                }
+            }
+
+            const IndexDim& shape() const {
+                return dim;
+            }
+
+            /** Words of the node row (y, z), `row_words()` of them, node x at bit `x % 64` of word `x / 64` */
+            const uint64_t* row_bits(const int32_t y, const int32_t z) const {
+                return words.data() + (size_t) (y + z * dim.y) * words_per_row;
+            }
+
+            int32_t row_words() const {
+                return words_per_row;
+            }
+    };
+}
\ No newline at end of file
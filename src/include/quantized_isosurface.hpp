@@ -0,0 +1,196 @@
+#pragma once
+
+#include <isosurface.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace mbl {
+    /** Densities stored as IEEE half floats of their offset from `reference` (usually the isovalue).
+     * Offsets keep 11 significant bits however close they get to the reference, so edges crossing
+     * near it interpolate to within about 1/2000 of a cell, & sign is kept: a field classifies
+     * against the reference exactly as its float densities would. Offsets past 65504 store as infinite. */
+    struct HalfDensity {
+        using Stored = uint16_t;
+
+        float reference = 0.f;
+
+        /** Rounds `value` to the nearest half float (ties to even) */
+        static uint16_t to_half(const float value) {
+            const uint32_t bits = std::bit_cast<uint32_t>(value);
+            const uint16_t sign = (uint16_t) ((bits >> 16) & 0x8000);
+            const uint32_t magnitude = bits & 0x7FFFFFFF;
+
+            if (magnitude >= 0x7F800000) {
+                return sign | 0x7C00 | (magnitude > 0x7F800000 ? 0x200 : 0);   // infinite or NaN
+            }
+            if (magnitude >= 0x477FF000) {
+                return sign | 0x7C00;   // 65520 & up round past the largest half
+            }
+            if (magnitude < 0x38800000) {
+                // Subnormal: a count of 2^-24s, rounded in float (the default mode rounds ties to even)
+                return sign | (uint16_t) std::nearbyint(std::bit_cast<float>(magnitude) * 16777216.f);
+            }
+
+            // Rebias the exponent & round the mantissa from 23 to 10 bits, carries roll into the exponent
+            const uint32_t rebiased = magnitude - 0x38000000;
+            return sign | (uint16_t) ((rebiased + 0xFFF + ((rebiased >> 13) & 1)) >> 13);
+        }
+
+        static float to_float(const uint16_t half) {
+            const uint32_t sign = (uint32_t) (half & 0x8000) << 16;
+            const uint32_t exponent = (half >> 10) & 0x1F;
+            const uint32_t mantissa = half & 0x3FF;
+
+            if (exponent == 0) {
+                const float subnormal = (float) mantissa * 5.9604645e-8f;   // 2^-24
+                return sign != 0 ? -subnormal : subnormal;
+            }
+            if (exponent == 0x1F) {
+                return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+            }
+            return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+        }
+
+        Stored encode(const float density) const {
+            const float offset = density - reference;
+            const uint16_t half = to_half(offset);
+            if ((half & 0x7FFF) != 0) {
+                return half;
+            }
+            // Offsets too small for a half keep their side of the reference
+            return offset < 0.f ? 0x8001 : 0x0000;
+        }
+
+        float decode(const Stored stored) const {
+            return reference + to_float(stored);
+        }
+
+        /** Whether `stored` decodes to at least the reference, without decoding it (NaNs don't) */
+        static bool at_or_above_reference(const Stored stored) {
+            return stored <= 0x7C00;
+        }
+    };
+
+    /** Densities stored as 16 bit fixed point offsets from `reference` (usually the isovalue), in steps
+     * of `range / 32767`. Offsets past +-`range` saturate, so only edges with both ends within `range`
+     * of the reference interpolate accurately. Nonzero offsets never round to 0, so a field classifies
+     * against the reference exactly as its float densities would. */
+    struct FixedDensity {
+        using Stored = int16_t;
+
+        float reference = 0.f;
+        float range = 1.f;
+
+        Stored encode(const float density) const {
+            const float offset = density - reference;
+            if (std::isnan(offset)) {
+                return -32767;      // never inside, like a NaN float density
+            }
+
+            const float scaled = std::clamp(offset * (32767.f / range), -32767.f, 32767.f);
+            const int16_t stored = (int16_t) std::lround(scaled);
+            return stored == 0 && offset < 0.f ? -1 : stored;
+        }
+
+        float decode(const Stored stored) const {
+            return reference + (float) stored * (range / 32767.f);
+        }
+
+        /** Whether `stored` decodes to at least the reference, without decoding it */
+        static bool at_or_above_reference(const Stored stored) {
+            return stored >= 0;
+        }
+    };
+
+    /** Box shaped scalar field storing only the densities of its nodes, as `Density::Stored` (2 bytes
+     * rather than the 16 of an `IsoPoint`). Densities are encoded as they're stored & decoded as they're
+     * read, positions are computed from the node's index. Nodes are always laid out linearly.
+     *
+     * `Density` provides `Stored`, `Stored encode(float) const`, `float decode(Stored) const`, the
+     * `reference` densities are stored relative to & `static bool at_or_above_reference(Stored)`. */
+    template <typename Density>
+    class BasicIsoSurface {
+        private:
+            using Stored = typename Density::Stored;
+
+            glm::vec3 m_half_extents;
+            IndexDim m_partitions;
+            glm::vec3 m_center_position;
+            Density m_density;
+            std::vector<Stored> m_densities;
+
+            BasicIsoSurface(const glm::vec3& center, const glm::vec3& half_extents, const IndexDim& partitions, const Density& density)
+                : m_half_extents(half_extents), m_partitions(partitions), m_center_position(center), m_density(density),
+                  m_densities((size_t) (partitions.x + 1) * (partitions.y + 1) * (partitions.z + 1), density.encode(0.f)) {}
+
+        public:
+            /** Initializes a field over the same box as `construct(center, half_extents, partitions)` of
+             * `IsoSurface` would, every density 0, storing densities with `density` */
+            static BasicIsoSurface construct(const glm::vec3& center, const glm::vec3& half_extents, const IndexDim& partitions, const Density& density) {
+                assert(glm::all(glm::greaterThan(partitions, IndexDim(0))));
+                return BasicIsoSurface(center, half_extents, partitions, density);
+            }
+
+            /** Position of node `i`, placed as `IsoSurface` places it */
+            glm::vec3 get_position(const uint32_t i) const {
+                const glm::vec3 half_indices = glm::vec3(m_partitions) / 2.f;
+                const glm::vec3 ratios = (glm::vec3(compactor().unflatten((int32_t) i)) - half_indices) / half_indices;
+                return m_center_position + ratios * m_half_extents;
+            }
+
+            float get_density(const uint32_t i) const {
+                return m_density.decode(m_densities[i]);
+            }
+
+            /** Stores `density` at node `i`, quantized */
+            void set_density(const uint32_t i, const float density) {
+                m_densities[i] = m_density.encode(density);
+            }
+
+            /** Returns the encoding densities are stored with */
+            const Density& density_storage() const {
+                return m_density;
+            }
+
+            const Stored* data() const {
+                return m_densities.data();
+            }
+
+            IndexCompactor compactor() const {
+                return IndexCompactor(shape());
+            }
+
+            NodeLayout layout() const {
+                return NodeLayout::Linear;
+            }
+
+            size_t indices() const {
+                return m_densities.size();
+            }
+
+            IndexDim shape() const {
+                return m_partitions + 1;
+            }
+
+            const glm::vec3& get_origin() const {
+                return m_center_position;
+            }
+
+            const glm::vec3& half_extents() const {
+                return m_half_extents;
+            }
+
+            glm::vec3 min_corner() const {
+                return m_center_position - m_half_extents;
+            }
+
+            glm::vec3 cell_size() const {
+                return 2.f * m_half_extents / glm::vec3(m_partitions);
+            }
+    };
+}
\ No newline at end of file
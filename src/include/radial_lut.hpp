@@ -0,0 +1,194 @@
+#pragma once
+
+#include "../dependencies/glm/glm.hpp"
+
+#include <metaball.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace mbl {
+    namespace presets {
+        /**
+         * A radial profile `f(q)`, q being the squared distance from a center, sampled at evenly spaced q
+         * over [inner^2, cutoff^2] & read back by linear interpolation. Past the cutoff the table reads 0,
+         * inside `inner` it reads f(inner^2) (profiles that blow up at the center, like 1/q, need an inner
+         * radius where they're still finite).
+         *
+         * Building the table measures how far the interpolation strays from the profile, see `max_error`.
+         * */
+        class RadialTable {
+            private:
+                /** Points checked against the profile within each interval when the table is built */
+                static constexpr size_t CHECKS_PER_INTERVAL = 8;
+
+                std::vector<float> m_samples;   // intervals + 1 samples, then a copy of the last
+                float m_q_low;
+                float m_q_high;
+                float m_inv_step;
+                float m_interpolation_error = 0.f;
+                float m_cutoff_value;
+
+            public:
+                template <typename Profile>
+                RadialTable(const Profile& profile, const float cutoff, const size_t intervals = 1024, const float inner = 0.f)
+                    : m_samples(intervals + 2),
+                      m_q_low(inner * inner),
+                      m_q_high(cutoff * cutoff),
+                      m_inv_step((float) intervals / (cutoff * cutoff - inner * inner)),
+                      m_cutoff_value(std::abs((float) profile(cutoff * cutoff))) {
+                    assert(intervals > 0 && inner >= 0.f && cutoff > inner);
+
+                    const double step = ((double) m_q_high - m_q_low) / (double) intervals;
+                    for (size_t i = 0; i <= intervals; i++) {
+                        m_samples[i] = (float) profile((float) (m_q_low + step * (double) i));
+                        assert(std::isfinite(m_samples[i]));
+                    }
+                    m_samples[intervals + 1] = m_samples[intervals];    // read when q lands on the cutoff exactly
+
+                    for (size_t i = 0; i < intervals; i++) {
+                        for (size_t c = 1; c < CHECKS_PER_INTERVAL; c++) {
+                            const float q = (float) (m_q_low + step * ((double) i + (double) c / CHECKS_PER_INTERVAL));
+                            m_interpolation_error = std::max(m_interpolation_error, std::abs(lookup(q) - (float) profile(q)));
+                        }
+                    }
+                }
+
+                /** A copy of the table's bounds & a pointer to its samples. Reading through a view in a loop
+                 * keeps the compiler from reloading them after every store. */
+                struct View {
+                    const float* samples;
+                    float q_low;
+                    float q_high;
+                    float inv_step;
+                    float top;
+
+                    float lookup(const float q) const {
+                        // Selects & a multiply rather than std::clamp or a branch around the read,
+                        // either of which keeps loops of lookups from vectorizing
+                        const float scaled = (q - q_low) * inv_step;
+                        const float above = scaled > 0.f ? scaled : 0.f;
+                        const float u = above < top ? above : top;
+                        const int32_t i = (int32_t) u;
+                        const float t = u - (float) i;
+                        const float low = samples[i];
+                        const float high = samples[i + 1];
+                        return (q < q_high ? 1.f : 0.f) * (low + t * (high - low));
+                    }
+                };
+
+                View view() const {
+                    return View { m_samples.data(), m_q_low, m_q_high, m_inv_step, (float) intervals() };
+                }
+
+                float lookup(const float q) const {
+                    return view().lookup(q);
+                }
+
+                /** Largest difference between the table & its profile, per unit of scale: the interpolation
+                 * error measured at points between the samples, or the value dropped at the cutoff if that's
+                 * larger. A bound only for profiles that decay monotonically past the cutoff. */
+                float max_error() const {
+                    return std::max(m_interpolation_error, m_cutoff_value);
+                }
+
+                /** Largest difference between the table & its profile measured within [inner, cutoff) */
+                float interpolation_error() const {
+                    return m_interpolation_error;
+                }
+
+                float get_cutoff() const {
+                    return std::sqrt(m_q_high);
+                }
+
+                float get_inner() const {
+                    return std::sqrt(m_q_low);
+                }
+
+                size_t intervals() const {
+                    return m_samples.size() - 2;
+                }
+        };
+
+        /**
+         * Metaball whose value is `scale * table(q)`, q = wx*dx^2 + wy*dy^2 + wz*dz^2 being the (weighted)
+         * squared distance from its center. Every radial falloff costs the same multiply-adds & one table
+         * read, so arbitrary ones evaluate as cheaply as the built-in inverse square. Many metaballs
+         * can share one table.
+         *
+         * @code
+         * auto table = std::make_shared<const mbl::presets::RadialTable>(
+         *     [](float q) { return 1.f / (1.f + q * q); }, 4.f);
+         * mbl::MetaballEngine<mbl::presets::RadialLUTMetaball> me(...);
+         * me.add_metaball(mbl::presets::RadialLUTMetaball(table, glm::vec3(0.f)));
+         * @endcode
+         * */
+        class RadialLUTMetaball : public MetaballExpression<RadialLUTMetaball> {
+            private:
+                /** Points looked up at once in `compute_batch` */
+                static constexpr size_t LOOKUP_BLOCK = 64;
+
+                std::shared_ptr<const RadialTable> m_table;
+
+            public:
+                glm::vec3 m_center = glm::vec3(0.f);
+                float m_scale = 1.f;
+                glm::vec3 m_axis_weights = glm::vec3(1.f);
+
+                RadialLUTMetaball(std::shared_ptr<const RadialTable> table, const glm::vec3& center, const float scale = 1.f, const glm::vec3& axis_weights = glm::vec3(1.f))
+                    : m_table(std::move(table)), m_center(center), m_scale(scale), m_axis_weights(axis_weights) {
+                    assert(m_table && glm::all(glm::greaterThan(axis_weights, glm::vec3(0.f))));
+                }
+
+                float operator()(float x, float y, float z) const {
+                    const glm::vec3 d = m_center - glm::vec3(x, y, z);
+                    return m_scale * m_table->lookup(glm::dot(m_axis_weights, d * d));
+                }
+
+                /** Adds the metaball's value at each of the `n` points (xs[j], ys[j], zs[j]) onto out[j].
+                 * Values are looked up into a local block before they're added, so the compiler knows the
+                 * table reads can't alias `out` & vectorizes them with gathers where the target has them. */
+                void compute_batch(const float* xs, const float* ys, const float* zs, float* out, size_t n) const {
+                    const RadialTable::View table = m_table->view();
+                    std::array<float, LOOKUP_BLOCK> values;
+
+                    for (size_t start = 0; start < n; start += LOOKUP_BLOCK) {
+                        const size_t count = std::min(LOOKUP_BLOCK, n - start);
+                        for (size_t k = 0; k < count; k++) {
+                            const float dx = m_center.x - xs[start + k];
+                            const float dy = m_center.y - ys[start + k];
+                            const float dz = m_center.z - zs[start + k];
+                            values[k] = table.lookup(m_axis_weights.x * dx * dx + m_axis_weights.y * dy * dy + m_axis_weights.z * dz * dz);
+                        }
+                        for (size_t k = 0; k < count; k++) {
+                            out[start + k] += m_scale * values[k];
+                        }
+                    }
+                }
+
+                const RadialTable& get_table() const {
+                    return *m_table;
+                }
+
+                /** Largest difference from `m_scale` times the sampled profile, see `RadialTable::max_error` */
+                float max_error() const {
+                    return std::abs(m_scale) * m_table->max_error();
+                }
+
+                /** The metaball is 0 past the table's cutoff along its least weighted axis */
+                float get_support_radius() const {
+                    return m_table->get_cutoff() / std::sqrt(std::min({ m_axis_weights.x, m_axis_weights.y, m_axis_weights.z }));
+                }
+
+                BoundingBox get_bounding_box() const {
+                    const glm::vec3 extents = m_table->get_cutoff() / glm::sqrt(m_axis_weights);
+                    return BoundingBox{ m_center + extents, m_center - extents };
+                }
+        };
+    }
+}
\ No newline at end of file
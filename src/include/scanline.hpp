@@ -0,0 +1,112 @@
+#pragma once
+
+#include <isosurface.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+namespace mbl {
+    /** Maps each 4 bit column (bit b is node row y + (b & 1), z + (b >> 1)) to case bits, given
+     * the cube corner each column bit lands on */
+    constexpr std::array<uint8_t, 16> column_case_bits(const std::array<uint8_t, 4> corner_of_bit) {
+        std::array<uint8_t, 16> table = {};
+        for (uint8_t column = 0; column < 16; column++) {
+            for (uint8_t b = 0; b < 4; b++) {
+                table[column] |= (uint8_t) (((column >> b) & 0x1) << corner_of_bit[b]);
+            }
+        }
+        return table;
+    }
+
+    /** Classifies a whole row of cells (all cells sharing a y & z) at once.
+     *
+     * Every node of the row's four node rows (y/y+1, z/z+1) is read exactly once, with constant
+     * strides, & folded into a 4 bit "column" per x. Adjacent cells along x share a column, so a
+     * cell's case byte is just its low column's bits (corners 0, 3, 4 & 7) OR'd with its high
+     * column's bits (corners 1, 2, 5 & 6). */
+    class ScanlineClassifier {
+        private:
+            std::vector<uint8_t> columns;   // per node along x, bit b set if node row b is inside
+
+            // Case bits contributed by a cell's low (x) & high (x + 1) column
+            static constexpr std::array<uint8_t, 16> low_case = column_case_bits({ 0, 3, 4, 7 });
+            static constexpr std::array<uint8_t, 16> high_case = column_case_bits({ 1, 2, 5, 6 });
+
+            /** ORs `bit` into `out[x]` for every node `x` of `row` whose density is >= `threshold` */
+            static void mark_inside(const IsoPoint* row, const int32_t nodes, const float threshold, const uint8_t bit, uint8_t* out) {
+                int32_t x = 0;
+#if defined(__SSE2__)
+                // Each movemask bit spread to the low bit of its own byte
+                static constexpr uint32_t spread[16] = {
+                    0x00000000, 0x00000001, 0x00000100, 0x00000101, 0x00010000, 0x00010001, 0x00010100, 0x00010101,
+                    0x01000000, 0x01000001, 0x01000100, 0x01000101, 0x01010000, 0x01010001, 0x01010100, 0x01010101
+                };
+                static_assert(sizeof(IsoPoint) == 4 * sizeof(float), "scanline.hpp: IsoPoint is expected to be 4 packed floats.");
+
+                const __m128 limit = _mm_set1_ps(threshold);
+                const float* f = reinterpret_cast<const float*>(row);
+                for (; x + 4 <= nodes; x += 4) {
+                    // Pull the density (4th float) out of 4 consecutive IsoPoints
+                    const __m128 p0 = _mm_loadu_ps(f + 4 * x);
+                    const __m128 p1 = _mm_loadu_ps(f + 4 * x + 4);
+                    const __m128 p2 = _mm_loadu_ps(f + 4 * x + 8);
+                    const __m128 p3 = _mm_loadu_ps(f + 4 * x + 12);
+                    const __m128 d01 = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(3, 3, 3, 3));
+                    const __m128 d23 = _mm_shuffle_ps(p2, p3, _MM_SHUFFLE(3, 3, 3, 3));
+                    const __m128 d = _mm_shuffle_ps(d01, d23, _MM_SHUFFLE(2, 0, 2, 0));
+
+                    const int inside = _mm_movemask_ps(_mm_cmpge_ps(d, limit));
+                    uint32_t bytes;
+                    std::memcpy(&bytes, out + x, sizeof(bytes));
+                    bytes |= spread[inside] << bit;
+                    std::memcpy(out + x, &bytes, sizeof(bytes));
+                }
+#endif
+                for (; x < nodes; x++) {
+                    out[x] |= (uint8_t) ((uint8_t) (row[x].density >= threshold) << bit);
+                }
+            }
+
+        public:
+            /** Writes the case byte of every cell in the row starting at node `row` into `cases`
+             * (`nodes - 1` of them). `stride_y` & `stride_z` are the node index distances to the next
+             * row & slice. Returns false if no cell of the row is crossed by the surface, in which
+             * case `cases` may be left unwritten. */
+            bool classify_row(
+                const IsoPoint* row,
+                const int32_t nodes,
+                const int32_t stride_y,
+                const int32_t stride_z,
+                const float threshold,
+                uint8_t* cases
+            ) {
+                columns.assign((size_t) nodes, 0);
+                mark_inside(row, nodes, threshold, 0, columns.data());
+                mark_inside(row + stride_y, nodes, threshold, 1, columns.data());
+                mark_inside(row + stride_z, nodes, threshold, 2, columns.data());
+                mark_inside(row + stride_y + stride_z, nodes, threshold, 3, columns.data());
+
+                // All outside or all inside, nothing to march
+                uint8_t any = 0;
+                uint8_t all = 0xF;
+                for (const uint8_t column : columns) {
+                    any |= column;
+                    all &= column;
+                }
+                if (any == 0x0 || all == 0xF) {
+                    return false;
+                }
+
+                for (int32_t x = 0; x + 1 < nodes; x++) {
+                    cases[x] = low_case[columns[x]] | high_case[columns[x + 1]];
+                }
+                return true;
+            }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <isosurface.hpp>
+#include <occupancy.hpp>
+#include <common/graphics.hpp>
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace mbl {
+    /** Naive Surface Nets isosurface extraction (Gibson, 1998) over an `IsoSurface` whose densities are
+     * all current, classified by an `OccupancyVolume` built against the same threshold.
+     *
+     * The dual of marching cubes: every cell the surface crosses gets one vertex, at the mean of its
+     * edge crossings, & every crossed edge is spanned by a quad joining the vertices of the 4 cells
+     * around it. Vertices are shared & triangles are far better shaped than marching cubes' slivers. Edges
+     * on the field's boundary have fewer than 4 cells around them & get no quad, so surfaces are left
+     * open where the field cuts them, as with marching cubes. */
+    class SurfaceNets {
+        private:
+            std::vector<int32_t> row_vertex_base;   // first vertex of each cell row, indexed `y + z * cells.y`
+            IndexDim cells = IndexDim(0);           // cells per axis
+
+            /** Vertex of the crossed cell (x, y, z) */
+            int32_t vertex_of(const OccupancyVolume& occupancy, const int32_t x, const int32_t y, const int32_t z) const {
+                int32_t rank = 0;
+                for (int32_t w = 0; w < x >> 6; w++) {
+                    rank += std::popcount(occupancy.crossed_cells(y, z, w));
+                }
+                const uint64_t before = (uint64_t(1) << (x & 63)) - 1;
+                return row_vertex_base[y + z * cells.y] + rank + std::popcount(occupancy.crossed_cells(y, z, x >> 6) & before);
+            }
+
+            /** Appends the quad joining the 4 cells around a crossed edge, given counterclockwise about the
+             * edge's axis. `inside` is whether the edge's lower node is inside the surface. */
+            static void emit_quad(const int32_t (&quad)[4], const bool inside, common::graphics::MeshData& out) {
+                // Wound like the engine's marching cubes triangles: clockwise seen from outside, so
+                // clockwise about the axis when the lower node is inside
+                if (!inside) {
+                    out.indices.insert(out.indices.end(), { quad[0], quad[1], quad[2], quad[0], quad[2], quad[3] });
+                } else {
+                    out.indices.insert(out.indices.end(), { quad[0], quad[2], quad[1], quad[0], quad[3], quad[2] });
+                }
+            }
+
+        public:
+            /** Extracts the `threshold` isosurface of `field` into `out` (cleared first). `occupancy` must have
+             * been built from `field` against `threshold`. `normal_of(position)` gives each vertex's normal. */
+            template <typename NormalFn>
+            void extract(const IsoSurface& field, const OccupancyVolume& occupancy, const float threshold, NormalFn&& normal_of, common::graphics::MeshData& out) {
+                // Corners of each marching cubes edge, as node offsets (x, y, z)
+                static constexpr int32_t edge_corners[12][2][3] = {
+                    { { 0, 0, 0 }, { 1, 0, 0 } }, { { 0, 1, 0 }, { 1, 1, 0 } }, { { 0, 0, 1 }, { 1, 0, 1 } }, { { 0, 1, 1 }, { 1, 1, 1 } },
+                    { { 0, 0, 0 }, { 0, 1, 0 } }, { { 1, 0, 0 }, { 1, 1, 0 } }, { { 0, 0, 1 }, { 0, 1, 1 } }, { { 1, 0, 1 }, { 1, 1, 1 } },
+                    { { 0, 0, 0 }, { 0, 0, 1 } }, { { 1, 0, 0 }, { 1, 0, 1 } }, { { 0, 1, 0 }, { 0, 1, 1 } }, { { 1, 1, 0 }, { 1, 1, 1 } }
+                };
+
+                const IndexDim n = field.shape();
+                const int32_t stride_y = n.x;
+                const int32_t stride_z = n.x * n.y;
+                const IsoPoint* nodes = field.data();
+                cells = n - 1;
+
+                out.vertices.clear();
+                out.indices.clear();
+                row_vertex_base.resize((size_t) cells.y * cells.z);
+
+                // One vertex per crossed cell, at the mean of its edge crossings
+                for (int32_t z = 0; z < cells.z; z++) {
+                    for (int32_t y = 0; y < cells.y; y++) {
+                        row_vertex_base[y + z * cells.y] = (int32_t) out.vertices.size();
+                        occupancy.for_each_crossed_cell(y, z, [&](const int32_t x, const uint8_t) {
+                            const size_t cell = (size_t) x + (size_t) y * stride_y + (size_t) z * stride_z;
+                            glm::vec3 sum = glm::vec3(0.f);
+                            int32_t crossings = 0;
+                            for (const auto& edge : edge_corners) {
+                                const IsoPoint& p1 = nodes[cell + edge[0][0] + edge[0][1] * stride_y + edge[0][2] * stride_z];
+                                const IsoPoint& p2 = nodes[cell + edge[1][0] + edge[1][1] * stride_y + edge[1][2] * stride_z];
+                                if ((p1.density >= threshold) != (p2.density >= threshold)) {
+                                    sum += p1.position + (threshold - p1.density) * (p2.position - p1.position) / (p2.density - p1.density);
+                                    crossings += 1;
+                                }
+                            }
+
+                            const glm::vec3 position = sum / (float) crossings;
+                            out.vertices.push_back(common::graphics::Vertex { position, normal_of(position) });
+                        });
+                    }
+                }
+
+                // One quad per crossed edge with 4 cells around it. A node owns its +x, +y & +z edges
+                for (int32_t z = 0; z < n.z; z++) {
+                    for (int32_t y = 0; y < n.y; y++) {
+                        const uint64_t* bits = occupancy.row_bits(y, z);
+                        const uint64_t* above = y < cells.y ? occupancy.row_bits(y + 1, z) : nullptr;
+                        const uint64_t* behind = z < cells.z ? occupancy.row_bits(y, z + 1) : nullptr;
+
+                        for (int32_t w = 0; w < occupancy.row_words(); w++) {
+                            // x edges, cells around them in (y, z)
+                            if (y > 0 && y < cells.y && z > 0 && z < cells.z) {
+                                const uint64_t next = w + 1 < occupancy.row_words() ? bits[w + 1] : 0;
+                                const int32_t edges = cells.x - w * 64;
+                                const uint64_t valid = edges >= 64 ? ~uint64_t(0) : (uint64_t(1) << edges) - 1;
+                                uint64_t crossed = (bits[w] ^ ((bits[w] >> 1) | (next << 63))) & valid;
+                                while (crossed != 0) {
+                                    const int32_t x = w * 64 + std::countr_zero(crossed);
+                                    crossed &= crossed - 1;
+                                    const int32_t quad[4] = {
+                                        vertex_of(occupancy, x, y - 1, z - 1), vertex_of(occupancy, x, y, z - 1),
+                                        vertex_of(occupancy, x, y, z), vertex_of(occupancy, x, y - 1, z)
+                                    };
+                                    emit_quad(quad, occupancy.test(x, y, z), out);
+                                }
+                            }
+
+                            // y edges, cells around them in (z, x)
+                            if (above != nullptr && z > 0 && z < cells.z) {
+                                uint64_t crossed = bits[w] ^ above[w];
+                                while (crossed != 0) {
+                                    const int32_t x = w * 64 + std::countr_zero(crossed);
+                                    crossed &= crossed - 1;
+                                    if (x == 0 || x == cells.x) {
+                                        continue;
+                                    }
+                                    const int32_t quad[4] = {
+                                        vertex_of(occupancy, x - 1, y, z - 1), vertex_of(occupancy, x - 1, y, z),
+                                        vertex_of(occupancy, x, y, z), vertex_of(occupancy, x, y, z - 1)
+                                    };
+                                    emit_quad(quad, occupancy.test(x, y, z), out);
+                                }
+                            }
+
+                            // z edges, cells around them in (x, y)
+                            if (behind != nullptr && y > 0 && y < cells.y) {
+                                uint64_t crossed = bits[w] ^ behind[w];
+                                while (crossed != 0) {
+                                    const int32_t x = w * 64 + std::countr_zero(crossed);
+                                    crossed &= crossed - 1;
+                                    if (x == 0 || x == cells.x) {
+                                        continue;
+                                    }
+                                    const int32_t quad[4] = {
+                                        vertex_of(occupancy, x - 1, y - 1, z), vertex_of(occupancy, x, y - 1, z),
+                                        vertex_of(occupancy, x, y, z), vertex_of(occupancy, x - 1, y, z)
+                                    };
+                                    emit_quad(quad, occupancy.test(x, y, z), out);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+    };
+}
\ No newline at end of file
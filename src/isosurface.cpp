@@ -5,11 +5,26 @@ using namespace mbl;
 
 // INDEX COMPACTOR FUNCTIONS
 
+/** Bricks per axis of a bricked layout over `dim` */
+static IndexDim bricks_of(const IndexDim& dim) {
+    return (dim + IndexCompactor::BRICK_MASK) >> IndexCompactor::BRICK_SHIFT;
+}
+
 int IndexCompactor::flatten(int x, int y, int z) const {
-    return x + y * dim.x + z * dim.y * dim.x;
+    if (layout == NodeLayout::Linear) {
+        return x + y * dim.x + z * dim.y * dim.x;
+    }
+    return flatten_at(x, 0) + flatten_at(y, 1) + flatten_at(z, 2);
 }
 
 int IndexCompactor::flatten_at(int value, int axis) const {
+    if (layout == NodeLayout::Bricked) {
+        // Brick index (x fastest) times the points per brick, plus the point within the brick
+        const IndexDim bricks = bricks_of(dim);
+        const int32_t brick_strides[3] = { 1, bricks.x, bricks.x * bricks.y };
+        return ((value >> BRICK_SHIFT) * brick_strides[axis] << (3 * BRICK_SHIFT)) + ((value & BRICK_MASK) << (axis * BRICK_SHIFT));
+    }
+
     switch (axis) {
         case 0:
             return value;
@@ -23,13 +38,26 @@ int IndexCompactor::flatten_at(int value, int axis) const {
 }
 
 IndexDim IndexCompactor::unflatten(int i) const {
+    if (layout == NodeLayout::Bricked) {
+        const IndexDim bricks = bricks_of(dim);
+        const int32_t brick = i >> (3 * BRICK_SHIFT);
+        const IndexDim at = IndexDim(brick % bricks.x, (brick / bricks.x) % bricks.y, brick / (bricks.x * bricks.y));
+        const IndexDim local = IndexDim(i, i >> BRICK_SHIFT, i >> (2 * BRICK_SHIFT)) & BRICK_MASK;
+        return (at << BRICK_SHIFT) + local;
+    }
+
     return IndexDim(
         i % dim.x, 
-        i / dim.x,
+        (i / dim.x) % dim.y,
         i / (dim.x * dim.y)
     );
 }
 
+size_t IndexCompactor::size() const {
+    const IndexDim slots = layout == NodeLayout::Bricked ? bricks_of(dim) << BRICK_SHIFT : dim;
+    return (size_t) slots.x * slots.y * slots.z;
+}
+
 const IndexDim& IndexCompactor::dimensions() const {
     return dim;
 }
@@ -43,39 +71,87 @@ uint32_t pow_int(const uint32_t base, const uint32_t exp) {
     return acc;
 }
 
-uint32_t cube_int(const uint32_t base) {
-    return base * base * base;
+IsoSurface::BasicIsoSurface(const glm::vec3& center, const glm::vec3& half_extents, const IndexDim& partitions, const NodeLayout layout) 
+    : m_half_extents(half_extents), m_partitions(partitions), m_center_position(center), m_layout(layout) {
+    m_isopoints.reserve(compactor().size());
 }
 
-IsoSurface::IsoSurface(const glm::vec3& center, const float side_length, const uint32_t partitions) 
-    : m_center_position(center), m_side_length(side_length), m_partitions(partitions) {
-    const uint32_t size_cubed = cube_int(partitions + 1);
-    m_isopoints.reserve(size_cubed);
+void IsoSurface::place_points() {
+    const IndexDim axis_indices = m_partitions + 1;
+    const glm::vec3 half_indices = glm::vec3(m_partitions) / 2.f;
+    const IndexCompactor layout_compactor = compactor();
+
+    m_isopoints.clear();
+    m_isopoints.resize(layout_compactor.size());
+    for (const IndexDim& p_idx : FieldRange({ 0, axis_indices.x, 0, axis_indices.y, 0, axis_indices.z })) {
+        const glm::vec3 ratios = (glm::vec3(p_idx) - half_indices) / half_indices;
+        m_isopoints[layout_compactor.flatten(p_idx.x, p_idx.y, p_idx.z)] = IsoPoint(m_center_position + ratios * m_half_extents, 0.0f);
+    }
 }
 
 IsoSurface IsoSurface::construct(const glm::vec3& center, const float side_length, uint32_t partitions) {
     assert(partitions > 1);
     
     partitions -= (partitions & 0x1) == 1; // makes partition even if odd
-    const int axis_indices = partitions + 1;
-    const IndexDim mid_idx = IndexDim(axis_indices) / 2;
-
-    IsoSurface surface = IsoSurface(center, side_length, partitions);
-
-    glm::vec3 offset;
-    glm::vec3 ratios;
-    const float half_indices = (float) mid_idx.x;
-    for (const IndexDim& p_idx : FieldRange(0, axis_indices)) {
-        offset = glm::vec3(p_idx - mid_idx);
-        ratios = offset / half_indices;
-        surface.m_isopoints.emplace_back( center + ratios * side_length, 0.0f);
+    return construct(center, glm::vec3(side_length), IndexDim((int32_t) partitions));
+}
+
+IsoSurface IsoSurface::construct(const glm::vec3& center, const glm::vec3& half_extents, const IndexDim& partitions, const NodeLayout layout) {
+    assert(glm::all(glm::greaterThan(partitions, IndexDim(0))));
+
+    IsoSurface surface = IsoSurface(center, half_extents, partitions, layout);
+    surface.place_points();
+    return surface;
+}
+
+void IsoSurface::reshape(const glm::vec3& center, const glm::vec3& half_extents, const IndexDim& partitions) {
+    assert(glm::all(glm::greaterThan(partitions, IndexDim(0))));
+
+    m_center_position = center;
+    m_half_extents = half_extents;
+    m_partitions = partitions;
+    place_points();
+}
+
+IsoSurface IsoSurface::subsample(const IsoSurface& fine, const uint32_t step) {
+    const IndexDim coarse_partitions = fine.m_partitions / (int32_t) step;
+    assert(step > 0 && coarse_partitions * (int32_t) step == fine.m_partitions);
+
+    IsoSurface surface = IsoSurface(fine.m_center_position, fine.m_half_extents, coarse_partitions);
+    const IndexDim axis_indices = coarse_partitions + 1;
+    const IndexCompactor fine_compactor = fine.compactor();
+    for (const IndexDim& p_idx : FieldRange({ 0, axis_indices.x, 0, axis_indices.y, 0, axis_indices.z })) {
+        const IndexDim fine_idx = p_idx * (int32_t) step;
+        surface.m_isopoints.push_back(fine.m_isopoints[fine_compactor.flatten(fine_idx.x, fine_idx.y, fine_idx.z)]);
     }
 
     return surface;
 }
 
+void IsoSurface::resample(const IsoSurface& fine, const uint32_t step) {
+    assert(fine.m_partitions == m_partitions * (int32_t) step && fine.m_layout == NodeLayout::Linear);
+
+    const IndexDim axis_indices = m_partitions + 1;
+    const IndexDim fine_indices = fine.m_partitions + 1;
+    const IsoPoint* from = fine.m_isopoints.data();
+    IsoPoint* to = m_isopoints.data();
+    for (int32_t z = 0; z < axis_indices.z; z++) {
+        for (int32_t y = 0; y < axis_indices.y; y++) {
+            const IsoPoint* row = from + ((size_t) y * step + (size_t) z * step * fine_indices.y) * fine_indices.x;
+            for (int32_t x = 0; x < axis_indices.x; x++) {
+                to->density = row[(size_t) x * step].density;
+                to += 1;
+            }
+        }
+    }
+}
+
 IndexCompactor IsoSurface::compactor() const {
-    return IndexCompactor(m_partitions + 1);
+    return IndexCompactor(m_partitions + 1, m_layout);
+}
+
+NodeLayout IsoSurface::layout() const {
+    return m_layout;
 }
 
 size_t IsoSurface::indices() const {
@@ -83,11 +159,23 @@ size_t IsoSurface::indices() const {
 }
 
 IndexDim IsoSurface::shape() const {
-    return IndexDim(m_partitions + 1);
+    return m_partitions + 1;
 }
 
 float IsoSurface::length() const {
-    return this->m_side_length;
+    return this->m_half_extents.x;
+}
+
+const glm::vec3& IsoSurface::half_extents() const {
+    return this->m_half_extents;
+}
+
+glm::vec3 IsoSurface::min_corner() const {
+    return m_center_position - m_half_extents;
+}
+
+glm::vec3 IsoSurface::cell_size() const {
+    return 2.f * m_half_extents / glm::vec3(m_partitions);
 }
 
 std::vector<IsoPoint>& IsoSurface::isopoints() {
@@ -107,13 +195,11 @@ const IsoPoint& IsoSurface::get(uint32_t i) const {
 }
 
 IsoPoint& IsoSurface::get(uint32_t i, uint32_t j, uint32_t k) {
-    const uint32_t index = i + j * m_partitions + k * m_partitions * m_partitions;
-    return get(index);
+    return get((uint32_t) compactor().flatten(i, j, k));
 }
 
 const IsoPoint& IsoSurface::get(uint32_t i, uint32_t j, uint32_t k) const {
-    const uint32_t index = i + j * m_partitions + k * m_partitions * m_partitions;
-    return get(index);
+    return get((uint32_t) compactor().flatten(i, j, k));
 }
 
 glm::vec3& IsoSurface::get_position(uint32_t i) {
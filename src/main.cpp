@@ -15,6 +15,8 @@
 #include "convenience.hpp"
 #include "Shader.hpp"
 #include "Metaball.hpp"
+#include "MeshUploader.hpp"
+#include "include/common/decimate.hpp"
 
 struct MeshView {
     const std::vector<Vertex>* vertex_data;
@@ -22,16 +24,17 @@ struct MeshView {
 };
 
 template <size_t GRID_SIZE>
-void re_render_metaball_engine(MetaballEngine<GRID_SIZE>& me, MeshView& mview, GLuint& vbo, GLuint& ebo) {
+void re_render_metaball_engine(MetaballEngine<GRID_SIZE>& me, MeshView& mview, MeshUploader& uploader, uint64_t& revision) {
     me.refresh();
     mview.vertex_data = &me.get_vertices();
     mview.indices = &me.get_indices();
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, mview.vertex_data->size() * sizeof(Vertex), mview.vertex_data->data(), GL_DYNAMIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mview.indices->size() * sizeof(GLuint), mview.indices->data(), GL_DYNAMIC_DRAW);
+    revision += 1;
+    uploader.upload(
+        mview.vertex_data->data(), mview.vertex_data->size() * sizeof(Vertex), sizeof(Vertex),
+        mview.indices->data(), mview.indices->size() * sizeof(GLuint), mview.indices->size(),
+        revision
+    );
 }
 
 template<size_t SCENES, size_t GRID_SIZE>
@@ -39,6 +42,7 @@ struct MetaballSceneViewer {
     size_t scene_at = 0;
     std::array<MetaballEngine<GRID_SIZE>, SCENES> scenes;
     std::array<glm::vec3, SCENES> mball_color;
+    std::array<mbl::common::graphics::MeshData, SCENES> meshes;     // decimated on first view, scenes never change
 
     MetaballEngine<GRID_SIZE>& get_current_scene() {
         return this->scenes[this->scene_at];
@@ -130,6 +134,28 @@ MSV<NUM_SCENES, GRID_SIZE> setup_scenes() {
     return mball_scenes;
 }
 
+/** Uploads the current scene's mesh, building & decimating it the first time the scene is shown.
+ * Flat scenes (planes, cubes) lose most of their triangles for a one-time cost. */
+template <size_t S, size_t GRID_SIZE>
+void upload_scene(MSV<S, GRID_SIZE>& scenes, MeshUploader& uploader) {
+    mbl::common::graphics::MeshData& mesh = scenes.meshes[scenes.scene_at];
+    if (mesh.indices.empty()) {
+        const MetaballEngine<GRID_SIZE>& me = scenes.get_current_scene().refresh();
+        for (const Vertex& v : me.get_vertices()) {
+            mesh.vertices.push_back(mbl::common::graphics::Vertex { v.position, v.normal });
+        }
+        mesh.indices.assign(me.get_indices().begin(), me.get_indices().end());
+
+        mbl::common::graphics::DecimationOptions options;
+        options.max_error = 0.005f;     // a 20th of a cell
+        options.workers = std::max(std::thread::hardware_concurrency(), 1u);
+        mbl::common::graphics::decimate_mesh(mesh, options);
+    }
+
+    // Revision 0 is the undecimated first scene uploaded at startup
+    uploader.upload(mesh, scenes.scene_at + 1);
+}
+
 template <size_t S, size_t GRID_SIZE>
 void check_keypress(GLFWwindow* w, MSV<S, GRID_SIZE>& scenes) {
     if (glfwGetKey(w, GLFW_KEY_LEFT) == GLFW_PRESS) {
@@ -155,34 +181,29 @@ int metaball_scenes() {
     glGenVertexArrays(1, &vao);
     glBindVertexArray(vao);
     
-    GLuint vbo;
-    glGenBuffers(1, &vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, mv.vertex_data->size() * sizeof(Vertex), mv.vertex_data->data(), GL_STATIC_DRAW);
-
-    GLuint ebo;
-    glGenBuffers(1, &ebo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mv.indices->size() * sizeof(GLuint), mv.indices->data(), GL_STATIC_DRAW);
+    MeshUploader uploader;
+    uint64_t mesh_revision = 0;
+    uploader.upload(
+        mv.vertex_data->data(), mv.vertex_data->size() * sizeof(Vertex), sizeof(Vertex),
+        mv.indices->data(), mv.indices->size() * sizeof(GLuint), mv.indices->size(),
+        mesh_revision
+    );
 
     Shader s = Shader::from_file(
         "./src/shaders/vertex/vertex_lighting.vert",
         "./src/shaders/fragment/vertex_lighting.frag"
     ).value();
 
-    s.add_uniform("lightPos", [](GLuint pgrm, GLint loc) {
-        glUniform3fv(loc, 1, &glm::vec3(10.f, 10.f, 10.f)[0]);
-    });
-
-    s.add_uniform("color", [](GLuint pgrm, GLint loc) {
-        glUniform3fv(loc, 1, &glm::vec3(1.0f, 0.f, 0.f)[0]);
-    });
+    const UniformHandle<glm::vec3> u_color = s.uniform<glm::vec3>("color");
+    const UniformHandle<glm::mat4> u_mvp = s.uniform<glm::mat4>("MVP");
+    s.set_uniform(s.uniform<glm::vec3>("lightPos"), glm::vec3(10.f, 10.f, 10.f));
+    s.set_uniform(u_color, glm::vec3(1.0f, 0.f, 0.f));
 
     GLuint program = s.get_program_id();
     const GLint vpos_location = glGetAttribLocation(program, "pPos");
     const GLint vnorm_location = glGetAttribLocation(program, "pNorm");
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, uploader.vertex_buffer());
     glVertexAttribPointer(vpos_location, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), 0);
     glEnableVertexAttribArray(vpos_location);
 
@@ -211,11 +232,9 @@ int metaball_scenes() {
 
         if (scenes.scene_at != prev_scene) {
             prev_scene = scenes.scene_at;
-            re_render_metaball_engine(scenes.get_current_scene(), mv, vbo, ebo);
+            upload_scene(scenes, uploader);
 
-            s.add_uniform("color", [&scenes](GLuint pgrm, GLint loc) {
-                glUniform3fv(loc, 1, &scenes.get_current_color()[0]);
-            });
+            s.set_uniform(u_color, scenes.get_current_color());
         }
 
         int width, height;
@@ -227,14 +246,10 @@ int metaball_scenes() {
         glm::mat4 model = glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0, 1, 0));
         glm::mat4 view = camera.get_view();
         glm::mat4 mvp = proj * view * model;
-
-        s.add_uniform("MVP", [mvp](GLuint prog, GLint loc) { 
-            glUniformMatrix4fv(loc, 1, false, glm::value_ptr(mvp)); 
-        });
         
-        s.ping_all_uniforms().use();
+        s.set_uniform(u_mvp, mvp).use();
         glBindVertexArray(vao);
-        glDrawElements(GL_TRIANGLES, (GLsizei) mv.indices->size(), GL_UNSIGNED_INT, 0);
+        uploader.draw();
 
         glfwPollEvents();
         glfwSwapBuffers(win);
@@ -267,28 +282,23 @@ int animation_test() {
     glGenVertexArrays(1, &vao);
     glBindVertexArray(vao);
 
-    GLuint vbo;
-    glGenBuffers(1, &vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, mv.vertex_data->size() * sizeof(Vertex), mv.vertex_data->data(), GL_STATIC_DRAW);
-
-    GLuint ebo;
-    glGenBuffers(1, &ebo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mv.indices->size() * sizeof(GLuint), mv.indices->data(), GL_STATIC_DRAW);
+    // The mesh changes every frame, so stream it through a mapped ring
+    MeshUploader uploader(MeshUploader::Strategy::MappedRing);
+    uint64_t mesh_revision = 0;
+    uploader.upload(
+        mv.vertex_data->data(), mv.vertex_data->size() * sizeof(Vertex), sizeof(Vertex),
+        mv.indices->data(), mv.indices->size() * sizeof(GLuint), mv.indices->size(),
+        mesh_revision
+    );
 
     Shader s = Shader::from_file(
         "./src/shaders/vertex/vertex_lighting.vert",
         "./src/shaders/fragment/vertex_lighting.frag"
     ).value();
 
-    s.add_uniform("lightPos", [](GLuint pgrm, GLint loc) {
-        glUniform3fv(loc, 1, &glm::vec3(10.f, 10.f, 10.f)[0]);
-    });
-
-    s.add_uniform("color", [](GLuint pgrm, GLint loc) {
-        glUniform3fv(loc, 1, &glm::vec3(0.9f)[0]);
-    });
+    const UniformHandle<glm::mat4> u_mvp = s.uniform<glm::mat4>("MVP");
+    s.set_uniform(s.uniform<glm::vec3>("lightPos"), glm::vec3(10.f, 10.f, 10.f));
+    s.set_uniform(s.uniform<glm::vec3>("color"), glm::vec3(0.9f));
 
     GLuint program = s.get_program_id();
     const GLint vpos_location = glGetAttribLocation(program, "pPos");
@@ -332,17 +342,13 @@ int animation_test() {
         glm::mat4 view = camera.get_view();
         glm::mat4 mvp = proj * view /** model*/;
 
-        s.add_uniform("MVP", [mvp](GLuint prog, GLint loc) { 
-            glUniformMatrix4fv(loc, 1, false, glm::value_ptr(mvp)); 
-        });
-
         animated.position = 2.5f * glm::vec3(/*std::cos(currentFrame)*/ 0.f, 0.f, std::sin(currentFrame));
         anim2.position = -2.5f * glm::vec3(0.f, 0.f, std::sin(currentFrame));
         
-        s.ping_all_uniforms().use();
+        s.set_uniform(u_mvp, mvp).use();
         glBindVertexArray(vao);
-        re_render_metaball_engine(me, mv, vbo, ebo);
-        glDrawElements(GL_TRIANGLES, (GLsizei) mv.indices->size(), GL_UNSIGNED_INT, 0);
+        re_render_metaball_engine(me, mv, uploader, mesh_revision);
+        uploader.draw();
         
         glfwPollEvents();
         glfwSwapBuffers(win);
@@ -373,6 +379,7 @@ template <typename T> using Ptr = T*;
 #include <metaball.hpp>
 #include <metaball_presets.hpp>
 #include <engine.hpp>
+#include <async_engine.hpp>
 
 int bouncing() {
     const glm::vec3 center = glm::vec3(0.f);
@@ -381,7 +388,10 @@ int bouncing() {
     const float iso_value = 1.f;
     const int32_t num_metaballs = 10;
 
-    mbl::MetaballEngine<mbl::Metaball<mbl::presets::KineticBlob>> engine(center, side_length, resolution, iso_value);
+    using BlobEngine = mbl::MetaballEngine<mbl::Metaball<mbl::presets::KineticBlob>>;
+    BlobEngine engine(center, side_length, resolution, iso_value);
+    engine.set_extraction_mode(mbl::ExtractionMode::Tracking);     // blobs move little between frames
+    engine.set_auto_fit(side_length / resolution, 1.f);            // only mesh the space around the blobs
     for (int i = 0; i < num_metaballs; i++) {
         glm::vec3 position = glm::linearRand(glm::vec3(-5.f), glm::vec3(5.f));
         glm::vec3 velocity = glm::sphericalRand(1.f);
@@ -390,44 +400,31 @@ int bouncing() {
 
     mbl::common::graphics::MeshData md = engine.construct_mesh();
 
+    // Meshes are built on a worker thread from here on
+    mbl::AsyncMetaballEngine<mbl::Metaball<mbl::presets::KineticBlob>> async_engine(std::move(engine));
+
     const int SCREEN_WIDTH = 640;
     const int SCREEN_HEIGHT = 480;
     GLFWwindow* win = setup(SCREEN_WIDTH, SCREEN_HEIGHT, "Marching Cubes (Refactor) Test").open();
 
-    unsigned int VBO, EBO;
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
     // Bind Vertex Array Object first
     unsigned int VAO;
     glGenVertexArrays(1, &VAO);
     glBindVertexArray(VAO);
 
-    // Copy vertex data into VBO
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, md.vertices.size() * sizeof(Vertex), md.vertices.data(), GL_STATIC_DRAW);
-
-    // Copy index data into EBO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, md.indices.size() * sizeof(int), md.indices.data(), GL_STATIC_DRAW);
+    // Copy vertex & index data into the uploader's buffers (binds them to the VAO)
+    MeshUploader uploader(MeshUploader::Strategy::MappedRing);
+    uploader.upload(md, 0);
     
     Shader shader = Shader::from_file(
         "./src/shaders/vertex/vertex_lighting.vert",
         "./src/shaders/fragment/vertex_lighting_rgb.frag"
     ).value();
 
-    shader.add_uniform("lightPos", [](GLuint pgrm, GLint loc) {
-        glUniform3fv(loc, 1, &glm::vec3(10.f, 10.f, 10.f)[0]);
-    });
-
-    shader.add_uniform("color", [](GLuint pgrm, GLint loc) {
-        glUniform3fv(loc, 1, &glm::vec3(1.f, 0.f, 0.f)[0]);
-    });
-
-    glm::vec3 camera_pos = camera.position;
-    shader.add_uniform("camera_pos", [&camera_pos](GLuint pgrm, GLint loc) {
-        glUniform3fv(loc, 1, &camera_pos[0]);
-    });
+    const UniformHandle<glm::mat4> u_mvp = shader.uniform<glm::mat4>("MVP");
+    const UniformHandle<glm::vec3> u_camera_pos = shader.uniform<glm::vec3>("camera_pos");
+    shader.set_uniform(shader.uniform<glm::vec3>("lightPos"), glm::vec3(10.f, 10.f, 10.f));
+    shader.set_uniform(shader.uniform<glm::vec3>("color"), glm::vec3(1.f, 0.f, 0.f));
 
     GLuint program = shader.get_program_id();
     const GLint vpos_location = glGetAttribLocation(program, "pPos");
@@ -473,45 +470,36 @@ int bouncing() {
         glm::mat4 view = camera.get_view();
         glm::mat4 mvp = proj * view;
 
-        for (int i = 0; i < num_metaballs; i++) {
-            mbl::presets::KineticBlob& kb = engine.get_metaball((size_t) i).unwrap();
-            glm::vec3& kb_pos = kb.update(deltaTime);
-
-            for (int i = 0; i < 3; i++) {
-                if (kb_pos[i] < -5.f + 1.0f) {
-                    kb_pos[i] = -4.0f;
-                    kb.m_velocity[i] *= -1;
-                } else if (kb_pos[i] > 5.f - 1.0f) {
-                    kb_pos[i] = 4.0f;
-                    kb.m_velocity[i] *= -1;
-                }
+        async_engine.request_mesh([deltaTime](BlobEngine& engine) {
+            engine.clear_changes();
+            for (size_t i = 0; i < engine.num_metaballs(); i++) {
+                engine.update_metaball(engine.handle_of(i), [deltaTime](mbl::Metaball<mbl::presets::KineticBlob>& m) {
+                    mbl::presets::KineticBlob& kb = m.unwrap();
+                    glm::vec3& kb_pos = kb.update(deltaTime);
+
+                    for (int i = 0; i < 3; i++) {
+                        if (kb_pos[i] < -5.f + 1.0f) {
+                            kb_pos[i] = -4.0f;
+                            kb.m_velocity[i] *= -1;
+                        } else if (kb_pos[i] > 5.f - 1.0f) {
+                            kb_pos[i] = 4.0f;
+                            kb.m_velocity[i] *= -1;
+                        }
+                    }
+                });
             }
-        }
-        
-        engine.make_dirty();
-        md = engine.construct_mesh();
+        });
         
+        // Only uploads when the worker has finished a new mesh (generation 0 is the mesh above)
+        const mbl::MeshFrame frame = async_engine.acquire_latest();
         glBindVertexArray(VAO);
-
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, md.vertices.size() * sizeof(Vertex), md.vertices.data(), GL_STATIC_DRAW);
-
-        // Copy index data into EBO
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, md.indices.size() * sizeof(int), md.indices.data(), GL_STATIC_DRAW);
+        uploader.upload(*frame.mesh, frame.generation);
  
-        shader.add_uniform("MVP", [mvp](GLuint prog, GLint loc) { 
-            glUniformMatrix4fv(loc, 1, false, glm::value_ptr(mvp)); 
-        });
-
-        glm::vec3 camera_pos = camera.position;
-        shader.add_uniform("camera_pos", [&camera_pos](GLuint pgrm, GLint loc) {
-            glUniform3fv(loc, 1, &camera_pos[0]);
-        });
-
-        shader.ping_all_uniforms().use();
+        shader.set_uniform(u_mvp, mvp)
+            .set_uniform(u_camera_pos, camera.position)
+            .use();
         glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, (GLsizei) md.indices.size(), GL_UNSIGNED_INT, 0);
+        uploader.draw();
         // glDrawElements(GL_TRIANGLES, (GLsizei) indices.size(), GL_UNSIGNED_INT, 0);
         
         glfwPollEvents();
@@ -5,7 +5,8 @@ using CubeView = MarchingCubeRange::CubeView;
 using CubeViewIterator = CubeView::CubeViewIterator;
 using MarchingCubeIterator = MarchingCubeRange::MarchingCubeIterator;
 
-MarchingCubeRange::MarchingCubeRange(IsoSurface& surface) : m_data(surface.data()), reshaper(surface.shape()[0]), field(0, surface.shape()[0] - 1) {}
+MarchingCubeRange::MarchingCubeRange(IsoSurface& surface) 
+    : m_data(surface.data()), reshaper(surface.compactor()), field({ 0, surface.shape().x - 1, 0, surface.shape().y - 1, 0, surface.shape().z - 1 }) {}
 
 MarchingCubeRange::~MarchingCubeRange() {}
 
@@ -2,14 +2,33 @@
 
 uniform mat4 MVP;
 
+// Set when drawing a CompactMeshData. pPos then holds positions normalized to [0, 1] within
+// the mesh's bounds, pNorm.xy an octahedron encoded normal in [-1, 1]
+uniform bool compactVertices;
+uniform vec3 boundsMin;
+uniform vec3 boundsSize;
+
 in vec3 pPos;
 in vec3 pNorm;
 
 out vec3 normal;
 out vec4 wsPos;
 
+vec3 octahedron_decode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += mix(vec2(t), vec2(-t), greaterThanEqual(n.xy, vec2(0.0)));
+    return normalize(n);
+}
+
 void main() {
+    vec3 position = pPos;
     normal = pNorm;
-    wsPos = vec4(pPos, 1.0);
-    gl_Position = MVP * vec4(pPos, 1.0);
+    if (compactVertices) {
+        position = boundsMin + pPos * boundsSize;
+        normal = octahedron_decode(pNorm.xy);
+    }
+
+    wsPos = vec4(position, 1.0);
+    gl_Position = MVP * vec4(position, 1.0);
 }
\ No newline at end of file
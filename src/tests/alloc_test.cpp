@@ -0,0 +1,141 @@
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+#include "test_scenes.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+using namespace mbl;
+using namespace test_scenes;
+using GyroidEngine = MetaballEngine<Metaball<presets::Gyroid>>;
+
+/** Every heap allocation made by this program */
+static size_t allocations = 0;
+
+void* operator new(const size_t size) {
+    allocations += 1;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const size_t) noexcept {
+    std::free(p);
+}
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+static constexpr int WARM_UP_FRAMES = 20;
+static constexpr int COUNTED_FRAMES = 60;
+static constexpr int32_t RESOLUTION = 40;
+static constexpr float FRAME_SECONDS = 0.05f;
+
+/** Fades the gyroids a little, like `step` moves the blobs */
+static void step(GyroidEngine& engine, const float dt) {
+    for (size_t i = 0; i < engine.num_metaballs(); i++) {
+        engine.update_metaball(engine.handle_of(i), [dt](Metaball<presets::Gyroid>& m) { m.unwrap().m_weights *= 1.f - dt / 5.f; });
+    }
+}
+
+/** Animates `engine` through `build` until its buffers settle, then counts the allocations of every later frame */
+template <typename Engine, typename Build>
+static bool allocation_free(Engine& engine, Build build) {
+    for (int frame = 0; frame < WARM_UP_FRAMES; frame++) {
+        step(engine, FRAME_SECONDS);
+        build(engine);
+    }
+
+    const size_t before = allocations;
+    for (int frame = 0; frame < COUNTED_FRAMES; frame++) {
+        step(engine, FRAME_SECONDS);
+        build(engine);
+    }
+    std::cout << "\t" << allocations - before << " allocations over " << COUNTED_FRAMES << " frames" << std::endl;
+    return allocations == before;
+}
+
+static bool mode_allocation_free(const ExtractionMode mode) {
+    KineticEngine engine = make_engine(RESOLUTION, mode);
+    return allocation_free(engine, [](KineticEngine& e) { e.construct_mesh(); });
+}
+
+static bool backend_allocation_free(const ExtractionBackend backend) {
+    KineticEngine engine = make_engine(RESOLUTION);
+    engine.set_extraction_backend(backend, 1);
+    return allocation_free(engine, [](KineticEngine& e) { e.construct_mesh(); });
+}
+
+bool full_scan_test() {
+    return mode_allocation_free(ExtractionMode::FullScan);
+}
+
+bool tracking_test() {
+    return mode_allocation_free(ExtractionMode::Tracking);
+}
+
+bool seeded_test() {
+    return mode_allocation_free(ExtractionMode::Seeded);
+}
+
+// Flying edges & surface nets share vertices between triangles, their indices are reserved apart
+bool flying_edges_test() {
+    return backend_allocation_free(ExtractionBackend::FlyingEdges);
+}
+
+bool surface_nets_test() {
+    return backend_allocation_free(ExtractionBackend::SurfaceNets);
+}
+
+bool layers_test() {
+    KineticEngine engine = make_engine(RESOLUTION);
+    const std::vector<float> isovalues = { 0.5f, 1.f, 2.f };
+    return allocation_free(engine, [&isovalues](KineticEngine& e) { e.construct_meshes(isovalues); });
+}
+
+bool compact_test() {
+    KineticEngine engine = make_engine(RESOLUTION);
+    common::graphics::CompactMeshData<int8_t> compact;
+    return allocation_free(engine, [&compact](KineticEngine& e) { e.construct_mesh(compact); });
+}
+
+// Separable metaballs sum their densities in buffers the engine keeps
+bool separable_test() {
+    GyroidEngine engine(glm::vec3(0.f), 12.f, 40, 0.5f);
+    engine.add_metaball(Metaball(presets::Gyroid()));
+    engine.add_metaball(Metaball(presets::Gyroid(glm::vec3(0.5f, 1.f, 0.25f))));
+    return allocation_free(engine, [](GyroidEngine& e) { e.construct_mesh(); });
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Full Scan Steady State #1", full_scan_test },
+        { "Tracking Steady State #1", tracking_test },
+        { "Seeded Steady State #1", seeded_test },
+        { "Flying Edges Steady State #1", flying_edges_test },
+        { "Surface Nets Steady State #1", surface_nets_test },
+        { "Layers Steady State #1", layers_test },
+        { "Compact Steady State #1", compact_test },
+        { "Separable Steady State #1", separable_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nALLOCATION TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,172 @@
+#include <async_engine.hpp>
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+#include "test_scenes.hpp"
+
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <map>
+#include <thread>
+#include <vector>
+
+using namespace mbl;
+using namespace test_scenes;
+using AsyncEngine = AsyncMetaballEngine<Metaball<presets::KineticBlob>>;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+static constexpr int REQUESTS = 40;
+static constexpr int32_t RESOLUTION = 30;
+
+/** Moves the first blob to where request `request` puts it, so a mesh tells which request it includes */
+static void place(KineticEngine& engine, const int request) {
+    engine.update_metaball(engine.handle_of(0), [request](Metaball<presets::KineticBlob>& m) {
+        m.unwrap().m_center = glm::vec3(-2.f + 0.1f * (float) request, 0.f, 0.f);
+    });
+}
+
+static bool same_mesh(const common::graphics::MeshData& a, const common::graphics::MeshData& b) {
+    bool same = a.indices == b.indices && a.vertices.size() == b.vertices.size();
+    for (size_t i = 0; same && i < a.vertices.size(); i++) {
+        same = a.vertices[i].position == b.vertices[i].position;
+    }
+    return same;
+}
+
+/** Acquires from `async` until `result` resolves, as the consumer of a double buffered engine must */
+static uint64_t wait_acquiring(AsyncEngine& async, std::future<uint64_t>& result) {
+    while (result.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready) {
+        async.acquire_latest();
+        std::this_thread::yield();
+    }
+    return result.get();
+}
+
+// Requests resolve to increasing generations & every acquired mesh is the whole mesh of the newest
+// request built into it, never older than a generation already resolved
+static bool generations(const BufferingPolicy policy) {
+    AsyncEngine async(make_engine(RESOLUTION), policy);
+    std::vector<std::future<uint64_t>> results;
+    std::map<uint64_t, common::graphics::MeshData> acquired;
+
+    bool ordered = async.buffering() == policy;
+    uint64_t latest = 0;
+    auto acquire = [&]() {
+        const MeshFrame frame = async.acquire_latest();
+        ordered = ordered && frame.generation >= latest && frame.mesh != nullptr;
+        latest = frame.generation;
+
+        // A held slot isn't written to, seeing a generation again shows the same mesh
+        const auto [it, first] = acquired.emplace(frame.generation, *frame.mesh);
+        ordered = ordered && (first || same_mesh(it->second, *frame.mesh));
+    };
+
+    // Pausing every few requests lets builds finish in between, others coalesce
+    for (int i = 0; i < REQUESTS; i++) {
+        results.push_back(async.request_mesh([i](KineticEngine& e) { place(e, i); }));
+        acquire();
+        if (i % 3 == 2) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            acquire();
+        }
+    }
+
+    std::map<uint64_t, int> newest_request;
+    uint64_t previous = 0;
+    for (int i = 0; i < REQUESTS; i++) {
+        const uint64_t generation = wait_acquiring(async, results[i]);
+        ordered = ordered && generation >= previous && generation > 0;
+        previous = generation;
+        newest_request[generation] = i;
+
+        acquire();
+        ordered = ordered && latest >= generation;
+    }
+
+    for (const auto& [generation, mesh] : acquired) {
+        if (generation == 0) {
+            ordered = ordered && mesh.indices.empty();
+            continue;
+        }
+        const auto request = newest_request.find(generation);
+        KineticEngine expected = make_engine(RESOLUTION);
+        ordered = ordered && request != newest_request.end();
+        if (request != newest_request.end()) {
+            place(expected, request->second);
+            ordered = ordered && same_mesh(mesh, expected.construct_mesh());
+        }
+    }
+    std::cout << "\t" << REQUESTS << " requests, " << previous << " builds, " << acquired.size() << " meshes acquired" << std::endl;
+    return ordered;
+}
+
+bool triple_generations_test() {
+    return generations(BufferingPolicy::Triple);
+}
+
+bool double_generations_test() {
+    return generations(BufferingPolicy::Double);
+}
+
+// While the worker is stuck in an update, acquiring returns the last finished mesh right away
+static bool never_blocks(const BufferingPolicy policy) {
+    AsyncEngine async(make_engine(RESOLUTION), policy);
+    std::future<uint64_t> first = async.request_mesh();
+    const uint64_t built = wait_acquiring(async, first);
+    const MeshFrame before = async.acquire_latest();
+
+    std::promise<void> gate;
+    std::shared_future<void> opened = gate.get_future().share();
+    std::future<uint64_t> held = async.request_mesh([opened](KineticEngine&) { opened.wait(); });
+
+    bool returned = before.generation == built;
+    for (int k = 0; k < 1000; k++) {
+        const MeshFrame frame = async.acquire_latest();
+        returned = returned && frame.generation == built && frame.mesh == before.mesh;
+    }
+    gate.set_value();
+
+    const uint64_t next = wait_acquiring(async, held);
+    return returned && next == built + 1 && async.acquire_latest().generation == next;
+}
+
+bool triple_never_blocks_test() {
+    return never_blocks(BufferingPolicy::Triple);
+}
+
+bool double_never_blocks_test() {
+    return never_blocks(BufferingPolicy::Double);
+}
+
+// Handing an engine over moves its metaballs rather than copying them
+bool engine_moves_test() {
+    KineticEngine engine = make_engine(RESOLUTION);
+    KineticEngine moved(std::move(engine));
+    return engine.num_metaballs() == 0 && moved.num_metaballs() == 3;
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Triple Generations #1", triple_generations_test },
+        { "Double Generations #1", double_generations_test },
+        { "Triple Never Blocks #1", triple_never_blocks_test },
+        { "Double Never Blocks #1", double_never_blocks_test },
+        { "Engine Moves #1", engine_moves_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nASYNC ENGINE TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include <blob_field.hpp>
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace mbl;
+using presets::BlobField;
+using presets::InverseSquareBlob;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+static constexpr float ISOVALUE = 1.f;
+static constexpr size_t BLOBS = 37;             // not a multiple of the field's lanes, so the tail loop runs too
+static constexpr float TOLERANCE = 1e-5f;       // relative, the field sums its blobs in another order
+
+/** `BLOBS` inverse square blobs with random centers & scales */
+static std::vector<InverseSquareBlob> random_blobs() {
+    std::mt19937 rng(26);
+    std::uniform_real_distribution<float> coordinate(-3.f, 3.f);
+    std::uniform_real_distribution<float> scale(0.01f, 0.2f);
+    std::vector<InverseSquareBlob> blobs;
+    for (size_t i = 0; i < BLOBS; i++) {
+        blobs.emplace_back(glm::vec3(coordinate(rng), coordinate(rng), coordinate(rng)), scale(rng));
+    }
+    return blobs;
+}
+
+static BlobField field_of(const std::vector<InverseSquareBlob>& blobs) {
+    BlobField field;
+    field.reserve(blobs.size());
+    for (const InverseSquareBlob& blob : blobs) {
+        field.add_blob(blob.m_center, blob.m_scale);
+    }
+    return field;
+}
+
+static std::vector<glm::vec3> random_points(const size_t n) {
+    std::mt19937 rng(62);
+    std::uniform_real_distribution<float> coordinate(-4.f, 4.f);
+    std::vector<glm::vec3> points(n);
+    for (glm::vec3& p : points) {
+        p = glm::vec3(coordinate(rng), coordinate(rng), coordinate(rng));
+    }
+    return points;
+}
+
+static bool close(const float value, const float expected) {
+    return std::abs(value - expected) <= TOLERANCE * std::abs(expected);
+}
+
+// The field sums to what the blobs sum to one at a time, & keeps the blobs it was given
+bool same_densities_test() {
+    const std::vector<InverseSquareBlob> blobs = random_blobs();
+    const BlobField field = field_of(blobs);
+
+    bool same = field.size() == blobs.size();
+    for (size_t i = 0; same && i < blobs.size(); i++) {
+        same = field.get_center(i) == blobs[i].m_center && field.get_scale(i) == blobs[i].m_scale;
+    }
+
+    for (const glm::vec3& p : random_points(4096)) {
+        float expected = 0.f;
+        for (const InverseSquareBlob& blob : blobs) {
+            expected += Metaball<InverseSquareBlob>(blob)(p.x, p.y, p.z);
+        }
+        same = same && close(field(p.x, p.y, p.z), expected);
+    }
+    return same;
+}
+
+// `compute_batch` adds the field onto what's already in `out`, matching `operator()`
+bool compute_batch_test() {
+    const BlobField field = field_of(random_blobs());
+    const std::vector<glm::vec3> points = random_points(1000);
+
+    std::vector<float> xs, ys, zs, out(points.size(), 1.f);
+    for (const glm::vec3& p : points) {
+        xs.push_back(p.x);
+        ys.push_back(p.y);
+        zs.push_back(p.z);
+    }
+    field.compute_batch(xs.data(), ys.data(), zs.data(), out.data(), points.size());
+
+    bool same = true;
+    for (size_t j = 0; j < points.size(); j++) {
+        same = same && close(out[j] - 1.f, field(points[j].x, points[j].y, points[j].z));
+    }
+    return same;
+}
+
+// An engine over one field fills in the same densities as an engine over the separate blobs
+bool engine_densities_test() {
+    const std::vector<InverseSquareBlob> blobs = random_blobs();
+    MetaballEngine<BlobField> fielded(glm::vec3(0.f), 8.f, 40, ISOVALUE);
+    MetaballEngine<Metaball<InverseSquareBlob>> separate(glm::vec3(0.f), 8.f, 40, ISOVALUE);
+    fielded.add_metaball(field_of(blobs));
+    for (const InverseSquareBlob& blob : blobs) {
+        separate.add_metaball(Metaball(blob));
+    }
+    fielded.update_densities();
+    separate.update_densities();
+
+    const IsoSurface& a = fielded.get_field();
+    const IsoSurface& b = separate.get_field();
+    bool same = a.indices() == b.indices();
+    for (uint32_t i = 0; same && i < a.indices(); i++) {
+        same = close(a.isopoints()[i].density, b.isopoints()[i].density);
+    }
+    return same && !fielded.construct_mesh().indices.empty();
+}
+
+// The field's box joins the boxes of its blobs
+bool bounding_box_test() {
+    const std::vector<InverseSquareBlob> blobs = random_blobs();
+    BoundingBox expected = blobs[0].get_bounding_box();
+    for (const InverseSquareBlob& blob : blobs) {
+        expected.join_mut(blob.get_bounding_box());
+    }
+
+    const BoundingBox box = field_of(blobs).get_bounding_box();
+    return box.max_point == expected.max_point && box.min_point == expected.min_point;
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Same Densities #1", same_densities_test },
+        { "Compute Batch #1", compute_batch_test },
+        { "Engine Densities #1", engine_densities_test },
+        { "Bounding Box #1", bounding_box_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nBLOB FIELD TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+#include "test_scenes.hpp"
+
+#include <iostream>
+#include <optional>
+#include <vector>
+
+using namespace mbl;
+using namespace test_scenes;
+using KineticBall = Metaball<presets::KineticBlob>;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+/** The box of `ball` once its center is moved by `offset` */
+static BoundingBox box_moved(const KineticBall& ball, const glm::vec3& offset) {
+    KineticBall moved = ball;
+    moved.unwrap().m_center += offset;
+    return moved.get_bounding_box();
+}
+
+static bool same_box(const std::optional<BoundingBox>& box, const BoundingBox& expected) {
+    return box.has_value() && box->min_point == expected.min_point && box->max_point == expected.max_point;
+}
+
+/** `change` is of the metaball at `index`, from `before` (none if added) to `after` */
+static bool is_change(const MetaballChange& change, const size_t index, const std::optional<BoundingBox>& before, const BoundingBox& after) {
+    const bool same_before = before.has_value() ? same_box(change.before, *before) : !change.before.has_value();
+    return change.index == index && change.added == !before.has_value() && same_before && same_box(change.after, after);
+}
+
+// Added metaballs are recorded as added, with only the box they were added with
+bool added_test() {
+    KineticEngine engine = make_engine();
+    const std::vector<MetaballChange>& changes = engine.get_changes();
+
+    bool recorded = changes.size() == 3 && !engine.has_untracked_changes();
+    for (size_t i = 0; recorded && i < changes.size(); i++) {
+        recorded = is_change(changes[i], i, std::nullopt, engine.get_metaball(i).get_bounding_box());
+    }
+    return recorded;
+}
+
+// Edits through `update_metaball` & `edit_metaball` to one metaball coalesce into one change,
+// from its box before the first edit to its box after the last
+bool coalesced_edits_test() {
+    KineticEngine engine = make_engine();
+    engine.clear_changes();
+    const KineticBall first = engine.get_metaball(1);
+    const KineticBall second = engine.get_metaball(2);
+
+    engine.update_metaball(engine.handle_of(1), [](KineticBall& m) { m.unwrap().m_center.x += 1.f; });
+    {
+        auto ball = engine.edit_metaball(engine.handle_of(1));
+        ball->unwrap().m_center.y += 0.5f;
+    }
+    {
+        auto ball = engine.edit_metaball(engine.handle_of(2));
+        ball->unwrap().m_center.z -= 2.f;
+    }
+    engine.update_metaball(engine.handle_of(1), [](KineticBall& m) { m.unwrap().m_center.z += 0.25f; });
+
+    const std::vector<MetaballChange>& changes = engine.get_changes();
+    return changes.size() == 2
+        && is_change(changes[0], 1, first.get_bounding_box(), box_moved(first, glm::vec3(1.f, 0.5f, 0.25f)))
+        && is_change(changes[1], 2, second.get_bounding_box(), box_moved(second, glm::vec3(0.f, 0.f, -2.f)))
+        && !engine.has_untracked_changes();
+}
+
+// A metaball edited after being added stays added, the guard records its box when it goes out of scope
+bool edited_after_add_test() {
+    KineticEngine engine(glm::vec3(0.f), 10.f, 20, 1.f);
+    const size_t index = engine.add_metaball(KineticBall(presets::KineticBlob(glm::vec3(0.f), glm::vec3(0.f))));
+    const KineticBall added = engine.get_metaball(index);
+
+    bool recorded = true;
+    {
+        auto ball = engine.edit_metaball(engine.handle_of(index));
+        ball->unwrap().m_center = glm::vec3(1.f, 2.f, 3.f);
+        recorded = is_change(engine.get_changes()[0], index, std::nullopt, added.get_bounding_box());
+    }
+
+    return recorded && engine.get_changes().size() == 1
+        && is_change(engine.get_changes()[0], index, std::nullopt, box_moved(added, glm::vec3(1.f, 2.f, 3.f)));
+}
+
+// Clearing forgets every change, the next edit starts a new one from the box as it is now
+bool clear_changes_test() {
+    KineticEngine engine = make_engine();
+    engine.update_metaball(engine.handle_of(0), [](KineticBall& m) { m.unwrap().m_center.x += 1.f; });
+    engine.clear_changes();
+    const bool cleared = engine.get_changes().empty();
+
+    const KineticBall moved = engine.get_metaball(0);
+    engine.update_metaball(engine.handle_of(0), [](KineticBall& m) { m.unwrap().m_center.x += 1.f; });
+
+    const std::vector<MetaballChange>& changes = engine.get_changes();
+    return cleared && changes.size() == 1
+        && is_change(changes[0], 0, moved.get_bounding_box(), box_moved(moved, glm::vec3(1.f, 0.f, 0.f)));
+}
+
+// Edits made through raw access aren't recorded, `make_dirty` & swapping flag them until the next clear
+bool untracked_test() {
+    KineticEngine engine = make_engine();
+    engine.clear_changes();
+
+    engine.get_metaball(0).unwrap().m_center.x += 1.f;
+    engine.make_dirty();
+    const bool flagged = engine.has_untracked_changes() && engine.get_changes().empty();
+
+    engine.clear_changes();
+    const bool unflagged = !engine.has_untracked_changes();
+
+    engine.update_metaball(engine.handle_of(1), [](KineticBall& m) { m.unwrap().m_center.x += 1.f; });
+    std::vector<KineticBall> other = engine.get_metaballs();
+    engine.swap_metaballs(other);
+    const bool swapped = engine.has_untracked_changes() && engine.get_changes().empty();
+
+    // Edits after a swap are recorded against the swapped in metaballs
+    const KineticBall swapped_in = engine.get_metaball(2);
+    engine.update_metaball(engine.handle_of(2), [](KineticBall& m) { m.unwrap().m_center.y += 1.f; });
+    const std::vector<MetaballChange>& changes = engine.get_changes();
+    return flagged && unflagged && swapped && changes.size() == 1
+        && is_change(changes[0], 2, swapped_in.get_bounding_box(), box_moved(swapped_in, glm::vec3(0.f, 1.f, 0.f)));
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Added #1", added_test },
+        { "Coalesced Edits #1", coalesced_edits_test },
+        { "Edited After Add #1", edited_after_add_test },
+        { "Clear Changes #1", clear_changes_test },
+        { "Untracked #1", untracked_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nCHANGE LOG TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
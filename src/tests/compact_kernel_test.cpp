@@ -0,0 +1,142 @@
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace mbl;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+/** A kernel of the base alone, 1 - r^2/R^2 */
+struct ConeBlob : public presets::CompactRadialKernel<ConeBlob> {
+    ConeBlob(const glm::vec3& center = glm::vec3(0.f), const float radius = 1.f, const float scale = 2.f)
+        : CompactRadialKernel(center, radius, scale) {}
+
+    float falloff(const float q) const {
+        return 1.f - q;
+    }
+};
+
+static_assert(HasCompactSupport<presets::WyvillBlob>::value);
+static_assert(HasCompactSupport<Metaball<presets::WyvillBlob>>::value);
+static_assert(HasCompactSupport<Metaball<presets::WendlandBlob>>::value);
+static_assert(HasCompactSupport<Metaball<presets::SoftObjectBlob>>::value);
+static_assert(HasCompactSupport<Metaball<ConeBlob>>::value);
+static_assert(!HasCompactSupport<presets::InverseSquareBlob>::value);
+static_assert(!HasCompactSupport<Metaball<presets::InverseSquareBlob>>::value);
+
+static const glm::vec3 CENTER(0.5f, -1.f, 2.f);
+static constexpr float RADIUS = 1.5f;
+static constexpr float SCALE = 3.f;
+
+/** Random unit directions */
+static std::vector<glm::vec3> random_directions(const size_t n) {
+    std::mt19937 rng(27);
+    std::normal_distribution<float> component(0.f, 1.f);
+    std::vector<glm::vec3> directions(n);
+    for (glm::vec3& d : directions) {
+        d = glm::normalize(glm::vec3(component(rng), component(rng), component(rng)));
+    }
+    return directions;
+}
+
+/** `SCALE` on the center, falling off without rising to exactly 0 at the support radius & past it */
+template <typename Kernel>
+static bool compact_support() {
+    const Metaball<Kernel> kernel(Kernel(CENTER, RADIUS, SCALE));
+    bool compact = kernel.get_support_radius() == RADIUS && kernel(CENTER.x, CENTER.y, CENTER.z) == SCALE;
+
+    for (const glm::vec3& d : random_directions(256)) {
+        float previous = SCALE;
+        for (int step = 1; step < 100; step++) {
+            const glm::vec3 p = CENTER + d * (RADIUS * (float) step / 100.f);
+            const float value = kernel(p.x, p.y, p.z);
+            compact = compact && value >= 0.f && value <= previous;
+            previous = value;
+        }
+
+        for (const float beyond : { 1.001f, 1.5f, 10.f }) {
+            const glm::vec3 p = CENTER + d * (RADIUS * beyond);
+            compact = compact && kernel(p.x, p.y, p.z) == 0.f;
+        }
+    }
+
+    // On the sphere exactly, along the axes where the distance doesn't round
+    for (int axis = 0; axis < 3; axis++) {
+        glm::vec3 p = CENTER;
+        p[axis] += RADIUS;
+        compact = compact && kernel(p.x, p.y, p.z) == 0.f;
+    }
+    return compact;
+}
+
+/** The bounding box is the support sphere's box */
+template <typename Kernel>
+static bool support_box() {
+    const BoundingBox box = Metaball<Kernel>(Kernel(CENTER, RADIUS, SCALE)).get_bounding_box();
+    return box.max_point == CENTER + glm::vec3(RADIUS) && box.min_point == CENTER - glm::vec3(RADIUS);
+}
+
+bool wyvill_test() {
+    return compact_support<presets::WyvillBlob>() && support_box<presets::WyvillBlob>();
+}
+
+bool wendland_test() {
+    return compact_support<presets::WendlandBlob>() && support_box<presets::WendlandBlob>();
+}
+
+bool soft_object_test() {
+    return compact_support<presets::SoftObjectBlob>() && support_box<presets::SoftObjectBlob>();
+}
+
+bool custom_kernel_test() {
+    return compact_support<ConeBlob>() && support_box<ConeBlob>();
+}
+
+// A field of compact kernels has no density outside the joined support boxes
+bool field_outside_support_test() {
+    MetaballEngine<Metaball<presets::WendlandBlob>> engine(glm::vec3(0.f), 8.f, 40, 0.5f);
+    engine.add_metaball(Metaball(presets::WendlandBlob(glm::vec3(-1.f, 0.f, 0.f), RADIUS, SCALE)));
+    engine.add_metaball(Metaball(presets::WendlandBlob(glm::vec3(1.f, 0.5f, 0.f), RADIUS, SCALE)));
+    engine.update_densities();
+
+    BoundingBox support = engine.get_metaball(0).get_bounding_box();
+    support.join_mut(engine.get_metaball(1).get_bounding_box());
+
+    const IsoSurface& field = engine.get_field();
+    bool outside_zero = !engine.construct_mesh().indices.empty();
+    for (uint32_t i = 0; i < field.indices(); i++) {
+        const glm::vec3& p = field.isopoints()[i].position;
+        const bool inside = glm::all(glm::lessThanEqual(p, support.max_point)) && glm::all(glm::greaterThanEqual(p, support.min_point));
+        outside_zero = outside_zero && (inside || field.isopoints()[i].density == 0.f);
+    }
+    return outside_zero;
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Wyvill #1", wyvill_test },
+        { "Wendland #1", wendland_test },
+        { "Soft Object #1", soft_object_test },
+        { "Custom Kernel #1", custom_kernel_test },
+        { "Field Outside Support #1", field_outside_support_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nCOMPACT KERNEL TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+#include <common/compact_mesh.hpp>
+
+#include <iostream>
+
+using namespace mbl;
+using namespace mbl::common::graphics;
+using KineticEngine = MetaballEngine<Metaball<presets::KineticBlob>>;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+static KineticEngine make_engine(const int32_t resolution) {
+    KineticEngine engine(glm::vec3(1.f, 2.f, 3.f), 10.f, resolution, 1.f);
+    engine.add_metaball(Metaball(presets::KineticBlob(glm::vec3(0.f, 2.f, 3.f))));
+    engine.add_metaball(Metaball(presets::KineticBlob(glm::vec3(2.f, 2.f, 3.f))));
+    engine.add_metaball(Metaball(presets::KineticBlob(glm::vec3(4.5f, -2.f, 3.f))));    // reaches the field's edges
+    return engine;
+}
+
+/** True if every decoded position is within `max_error` of the original & every decoded normal within `min_cosine` */
+template <typename N>
+static bool decodes_within(const MeshData& mesh, const CompactMeshData<N>& compact, const float max_error, const float min_cosine) {
+    if (compact.vertices.size() != mesh.vertices.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < mesh.vertices.size(); i++) {
+        const glm::vec3 position = decode_position(compact, compact.vertices[i]);
+        const glm::vec3 normal = decode_normal(compact.vertices[i]);
+        const glm::vec3 error = glm::abs(position - mesh.vertices[i].position);
+        if (glm::max(error.x, glm::max(error.y, error.z)) > max_error || glm::dot(normal, mesh.vertices[i].normal) < min_cosine) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Positions are within half a quantization step, 8-bit normals within ~1.5 degrees
+bool decode_8_test() {
+    KineticEngine engine = make_engine(30);
+    CompactMeshData<int8_t> compact;
+    engine.construct_mesh(compact);
+
+    const float step = 10.f / 65535.f;
+    return decodes_within(engine.construct_mesh(), compact, step, 0.9995f);
+}
+
+// 16-bit normals are nearly exact
+bool decode_16_test() {
+    KineticEngine engine = make_engine(30);
+    CompactMeshData<int16_t> compact;
+    engine.construct_mesh(compact);
+
+    const float step = 10.f / 65535.f;
+    return decodes_within(engine.construct_mesh(), compact, step, 0.99999f);
+}
+
+// Indices are 16 bit below 65536 vertices & 32 bit above, & survive either way
+bool index_width_test() {
+    MeshData mesh;
+    mesh.vertices.resize(70000, Vertex { glm::vec3(0.5f), glm::vec3(0.f, 0.f, 1.f) });
+    mesh.indices = { 0, 1, 69999 };
+
+    CompactMeshData<int8_t> wide;
+    encode_compact_mesh(mesh, glm::vec3(0.f), glm::vec3(1.f), wide);
+
+    mesh.vertices.resize(65536);
+    mesh.indices = { 0, 1, 65535 };
+    CompactMeshData<int8_t> narrow;
+    encode_compact_mesh(mesh, glm::vec3(0.f), glm::vec3(1.f), narrow);
+
+    return !wide.uses_short_indices() && wide.long_indices[2] == 69999 && wide.index_size() == 4
+        && narrow.uses_short_indices() && narrow.short_indices[2] == 65535 && narrow.index_size() == 2;
+}
+
+// The compact mesh takes at most half the bytes of the full mesh
+bool smaller_test() {
+    KineticEngine engine = make_engine(40);
+    const MeshData& mesh = engine.construct_mesh();
+    CompactMeshData<int8_t> compact;
+    engine.construct_mesh(compact);
+
+    const size_t full_bytes = mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(int32_t);
+    std::cout << "\t" << full_bytes << " bytes -> " << compact.byte_size() << " bytes" << std::endl;
+    return sizeof(CompactVertex8) == 8 && 2 * compact.byte_size() <= full_bytes;
+}
+
+// An unchanged mesh isn't re-encoded, a rebuilt one is
+bool reencode_test() {
+    KineticEngine engine = make_engine(20);
+    CompactMeshData<int8_t> compact;
+    engine.construct_mesh(compact);
+    const uint64_t first = compact.revision;
+
+    compact.vertices.clear();
+    engine.construct_mesh(compact);
+    const bool skipped = compact.vertices.empty() && compact.revision == first;
+
+    engine.set_isovalue(2.f);
+    engine.construct_mesh(compact);
+    return skipped && !compact.vertices.empty() && compact.revision != first;
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Decode 8-bit Normals #1", decode_8_test },
+        { "Decode 16-bit Normals #1", decode_16_test },
+        { "Index Width #1", index_width_test },
+        { "Smaller #1", smaller_test },
+        { "Re-encode #1", reencode_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nCOMPACT MESH TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+#include <common/decimate.hpp>
+#include "test_scenes.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <utility>
+
+using namespace mbl;
+using namespace mbl::common::graphics;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+static MeshData blob_mesh() {
+    return test_scenes::make_engine().construct_mesh();
+}
+
+/** A flat plane cut open by the field's edges */
+static MeshData plane_mesh() {
+    MetaballEngine<Metaball<presets::StickyPlane>> engine(glm::vec3(0.f), 10.f, 60, 1.f);
+    engine.add_metaball(Metaball(presets::StickyPlane(glm::vec3(0.f), 0.5f)));
+    return engine.construct_mesh();
+}
+
+/** True if every edge of `mesh` is on exactly two triangles, once in each direction */
+static bool is_watertight(const MeshData& mesh) {
+    std::map<std::pair<int32_t, int32_t>, int32_t> directed_edges;
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        for (size_t v = 0; v < 3; v++) {
+            directed_edges[{ mesh.indices[i + v], mesh.indices[i + (v + 1) % 3] }] += 1;
+        }
+    }
+
+    bool closed = !directed_edges.empty();
+    for (const auto& [edge, uses] : directed_edges) {
+        const auto opposite = directed_edges.find({ edge.second, edge.first });
+        closed = closed && uses == 1 && opposite != directed_edges.end() && opposite->second == 1;
+    }
+    return closed;
+}
+
+// A closed blob surface comes down to the target count & stays closed
+bool target_count_test() {
+    MeshData mesh = blob_mesh();
+    const size_t before = mesh.indices.size() / 3;
+
+    DecimationOptions options;
+    options.target_triangles = before / 10;
+    decimate_mesh(mesh, options);
+
+    const size_t after = mesh.indices.size() / 3;
+    std::cout << "\t" << before << " -> " << after << " triangles (target " << options.target_triangles << ")" << std::endl;
+    return after <= options.target_triangles * 11 / 10 && after >= options.target_triangles * 9 / 10 && is_watertight(mesh);
+}
+
+// Coplanar triangles collapse to almost nothing without leaving the plane
+bool flat_plane_test() {
+    MeshData mesh = plane_mesh();
+    const size_t before = mesh.indices.size() / 3;
+
+    DecimationOptions options;
+    options.max_error = 1e-3f;
+    decimate_mesh(mesh, options);
+
+    // x + y + z = -0.5 on the plane (density 0.5 - x - y - z at the isovalue 1)
+    bool on_plane = true;
+    for (const Vertex& v : mesh.vertices) {
+        on_plane = on_plane && std::fabs(v.position.x + v.position.y + v.position.z + 0.5f) < 1e-3f;
+    }
+
+    const size_t after = mesh.indices.size() / 3;
+    std::cout << "\t" << before << " -> " << after << " triangles" << std::endl;
+    return on_plane && after * 10 < before;
+}
+
+// Under an error bound, no vertex leaves the original surface by much more than that bound
+bool error_bound_test() {
+    MeshData mesh = blob_mesh();
+    const size_t before = mesh.indices.size() / 3;
+
+    DecimationOptions options;
+    options.max_error = 0.01f;
+    decimate_mesh(mesh, options);
+
+    const test_scenes::KineticEngine engine = test_scenes::make_engine();
+
+    bool near_surface = true;
+    for (const Vertex& v : mesh.vertices) {
+        near_surface = near_surface && std::fabs(engine.sum_metaballs(v.position) - 1.f) < 0.1f;
+    }
+
+    const size_t after = mesh.indices.size() / 3;
+    std::cout << "\t" << before << " -> " << after << " triangles" << std::endl;
+    return near_surface && after < before && is_watertight(mesh);
+}
+
+// Chunks are independent, so the result doesn't depend on how many threads worked on them
+bool threaded_test() {
+    MeshData serial = blob_mesh();
+    MeshData threaded = serial;
+
+    DecimationOptions options;
+    options.target_triangles = serial.indices.size() / 3 / 4;
+    decimate_mesh(serial, options);
+    options.workers = 4;
+    decimate_mesh(threaded, options);
+
+    bool equal = serial.indices == threaded.indices && serial.vertices.size() == threaded.vertices.size();
+    for (size_t i = 0; equal && i < serial.vertices.size(); i++) {
+        equal = serial.vertices[i].position == threaded.vertices[i].position;
+    }
+    return equal;
+}
+
+// Triangles with a non-finite corner are dropped & don't disturb the rest of the mesh
+bool non_finite_test() {
+    MeshData clean = blob_mesh();
+    MeshData broken = clean;
+    const int32_t first = (int32_t) broken.vertices.size();
+    for (const float bad : { std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN() }) {
+        Vertex v = broken.vertices[0];
+        v.position.y = bad;
+        broken.vertices.push_back(v);
+    }
+    broken.indices.insert(broken.indices.end(), { 0, 1, first, first + 1, 2, 3, 4, first, first + 1 });
+
+    DecimationOptions options;
+    options.max_error = 0.01f;
+    decimate_mesh(clean, options);
+    decimate_mesh(broken, options);
+
+    bool equal = clean.indices == broken.indices && clean.vertices.size() == broken.vertices.size();
+    for (size_t i = 0; equal && i < clean.vertices.size(); i++) {
+        equal = clean.vertices[i].position == broken.vertices[i].position;
+    }
+    return equal && is_watertight(broken);
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Target Count #1", target_count_test },
+        { "Flat Plane #1", flat_plane_test },
+        { "Error Bound #1", error_bound_test },
+        { "Threaded #1", threaded_test },
+        { "Non Finite #1", non_finite_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nDECIMATION TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
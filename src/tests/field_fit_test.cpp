@@ -0,0 +1,212 @@
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+#include "test_scenes.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace mbl;
+using namespace test_scenes;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+static constexpr float CELL_SIZE = 1.f / 6.f;
+static constexpr float MARGIN = 1.5f;
+
+static void add_cluster(KineticEngine& engine) {
+    engine.add_metaball(Metaball(presets::KineticBlob(glm::vec3(-1.f, 0.3f, 0.f), glm::vec3(1.f, 0.2f, 0.f))));
+    engine.add_metaball(Metaball(presets::KineticBlob(glm::vec3(0.8f, -0.4f, 0.2f), glm::vec3(-0.5f, 0.f, 0.5f))));
+    engine.add_metaball(Metaball(presets::KineticBlob(glm::vec3(0.f, 1.2f, -0.6f), glm::vec3(0.f, -1.f, 0.3f))));
+}
+
+// A rectangular field lays its nodes out like a cube of the same size would
+bool rectangular_layout_test() {
+    const IsoSurface field = IsoSurface::construct(glm::vec3(1.f, 0.f, -2.f), glm::vec3(3.f, 1.f, 2.f), IndexDim(6, 2, 8));
+    const IndexDim shape = field.shape();
+    const IndexCompactor compactor = field.compactor();
+
+    bool placed = shape == IndexDim(7, 3, 9) && field.indices() == 7 * 3 * 9
+        && field.min_corner() == glm::vec3(-2.f, -1.f, -4.f) && field.cell_size() == glm::vec3(1.f, 1.f, 0.5f);
+    for (int32_t z = 0; z < shape.z; z++) {
+        for (int32_t y = 0; y < shape.y; y++) {
+            for (int32_t x = 0; x < shape.x; x++) {
+                const glm::vec3 expected = field.min_corner() + glm::vec3(x, y, z) * field.cell_size();
+                placed = placed && glm::length(field.get_position((uint32_t) compactor.flatten(x, y, z)) - expected) < 1e-5f;
+            }
+        }
+    }
+    return placed;
+}
+
+// Fitting the field to the metaballs leaves the surface as it was in the engine's cube
+bool fitted_matches_cube_test() {
+    KineticEngine cube(glm::vec3(0.f), 10.f, 60, 1.f);
+    KineticEngine fitted(glm::vec3(0.f), 10.f, 60, 1.f);
+    add_cluster(cube);
+    add_cluster(fitted);
+    fitted.set_auto_fit(CELL_SIZE, MARGIN);
+
+    const common::graphics::MeshData& a = cube.construct_mesh();
+    const common::graphics::MeshData& b = fitted.construct_mesh();
+
+    std::cout << "\tcube: " << a.indices.size() / 3 << " triangles, fitted: " << b.indices.size() / 3 << " triangles" << std::endl;
+    return !a.indices.empty() && same_triangles(a, b);
+}
+
+// Clustered metaballs in a large field only pay for the cells around them
+bool fitted_cost_test() {
+    KineticEngine cube(glm::vec3(0.f), 20.f, 120, 1.f);
+    KineticEngine fitted(glm::vec3(0.f), 20.f, 120, 1.f);
+    add_cluster(cube);
+    add_cluster(fitted);
+    fitted.set_auto_fit(CELL_SIZE, MARGIN);
+
+    const size_t triangles = cube.construct_mesh().indices.size() / 3;
+    const ExtractionStats full = cube.get_extraction_stats();
+    const bool same = fitted.construct_mesh().indices.size() / 3 == triangles;
+    const ExtractionStats fit = fitted.get_extraction_stats();
+
+    std::cout << "\tcube: " << full.cells_visited << " cells, fitted: " << fit.cells_visited << " cells" << std::endl;
+    return same && fit.cells_visited * 20 < full.cells_visited;
+}
+
+// Refits grow & shrink the field in place once it has been as large as it will get
+bool storage_reused_test() {
+    KineticEngine engine(glm::vec3(0.f), 10.f, 10, 1.f);
+    add_cluster(engine);
+    engine.add_metaball(Metaball(presets::KineticBlob(glm::vec3(6.f, 4.f, 3.f))));
+    engine.set_auto_fit(CELL_SIZE, MARGIN);
+    engine.construct_mesh();
+
+    const IsoPoint* storage = engine.get_field().data();
+    const size_t large = engine.get_field().indices();
+    const IndexDim large_shape = engine.get_field().shape();
+
+    engine.update_metaball(engine.handle_of(3), [](Metaball<presets::KineticBlob>& m) { m.unwrap().m_center = glm::vec3(1.f, 0.f, 0.f); });
+    engine.construct_mesh();
+    const size_t small = engine.get_field().indices();
+    const bool shrunk = small < large && engine.get_field().data() == storage;
+
+    engine.update_metaball(engine.handle_of(3), [](Metaball<presets::KineticBlob>& m) { m.unwrap().m_center = glm::vec3(6.f, 4.f, 3.f); });
+    engine.construct_mesh();
+    const bool regrown = engine.get_field().shape() == large_shape && engine.get_field().data() == storage;
+
+    std::cout << "\t" << large << " nodes -> " << small << " nodes -> " << engine.get_field().indices() << " nodes" << std::endl;
+    return shrunk && regrown && large_shape.x != large_shape.y;
+}
+
+// Every extraction mode & backend agrees on moving metaballs in a field refitted each frame
+bool moving_fit_test() {
+    KineticEngine scanned(glm::vec3(0.f), 10.f, 60, 1.f);
+    KineticEngine tracked(glm::vec3(0.f), 10.f, 60, 1.f);
+    KineticEngine seeded(glm::vec3(0.f), 10.f, 60, 1.f);
+    KineticEngine flying(glm::vec3(0.f), 10.f, 60, 1.f);
+    KineticEngine nets(glm::vec3(0.f), 10.f, 60, 1.f);
+    tracked.set_extraction_mode(ExtractionMode::Tracking).set_tracking_options(1000, 2);
+    seeded.set_extraction_mode(ExtractionMode::Seeded);
+    flying.set_extraction_backend(ExtractionBackend::FlyingEdges, 1);
+    nets.set_extraction_backend(ExtractionBackend::SurfaceNets, 1);
+
+    for (KineticEngine* engine : { &scanned, &tracked, &seeded, &flying, &nets }) {
+        add_cluster(*engine);
+        engine->set_auto_fit(CELL_SIZE, MARGIN);
+    }
+
+    bool equal = true;
+    bool watertight = true;
+    size_t tracked_frames = 0;
+    size_t refits = 0;
+    IndexDim last_shape = IndexDim(0);
+    for (int frame = 0; frame < 30; frame++) {
+        for (KineticEngine* engine : { &scanned, &tracked, &seeded, &flying, &nets }) {
+            step(*engine, 0.05f);
+        }
+
+        // Every engine meshes each frame, a mismatch must not skip the rest
+        const common::graphics::MeshData& expected = scanned.construct_mesh();
+        const bool tracked_equal = same_triangles(tracked.construct_mesh(), expected);
+        const bool seeded_equal = same_triangles(seeded.construct_mesh(), expected);
+        const bool flying_equal = same_triangles(flying.construct_mesh(), expected);
+        equal = equal && !expected.indices.empty() && tracked_equal && seeded_equal && flying_equal;
+        tracked_frames += (size_t) !tracked.get_extraction_stats().full_scan;
+
+        // Surface nets meshes differ from marching cubes', but stay closed
+        const common::graphics::MeshData& net = nets.construct_mesh();
+        std::vector<std::array<int32_t, 2>> edges;
+        for (size_t i = 0; i + 2 < net.indices.size(); i += 3) {
+            for (size_t v = 0; v < 3; v++) {
+                edges.push_back({ net.indices[i + v], net.indices[i + (v + 1) % 3] });
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        for (const std::array<int32_t, 2>& edge : edges) {
+            watertight = watertight && std::binary_search(edges.begin(), edges.end(), std::array<int32_t, 2>{ edge[1], edge[0] });
+        }
+
+        refits += (size_t) (scanned.get_field().shape() != last_shape);
+        last_shape = scanned.get_field().shape();
+    }
+
+    std::cout << "\t" << refits << " refits, " << tracked_frames << " tracked frames" << std::endl;
+    return equal && watertight && refits > 1 && tracked_frames > 15;
+}
+
+// A metaball flying off or going non-finite can't grow the field past its limit
+bool bounded_fit_test() {
+    static constexpr int32_t MAX_PARTITIONS = 64;
+    KineticEngine engine(glm::vec3(0.f), 10.f, 60, 1.f);
+    add_cluster(engine);
+    engine.set_auto_fit(CELL_SIZE, MARGIN, MAX_PARTITIONS);
+    engine.construct_mesh();
+    const IndexDim fitted = engine.get_field().shape();
+
+    // One ball runs away: the field keeps at most MAX_PARTITIONS cells a side, between it & the cluster
+    engine.update_metaball(engine.handle_of(0), [](Metaball<presets::KineticBlob>& m) { m.unwrap().m_center = glm::vec3(1e6f, 0.f, 0.f); });
+    engine.construct_mesh();
+    const IndexDim far = engine.get_field().shape();
+
+    // Non-finite or unindexably far bounds leave the field as it was
+    engine.update_metaball(engine.handle_of(0), [](Metaball<presets::KineticBlob>& m) { m.unwrap().m_center = glm::vec3(std::nanf(""), 0.f, 0.f); });
+    engine.construct_mesh();
+    const IndexDim after_nan = engine.get_field().shape();
+    engine.update_metaball(engine.handle_of(0), [](Metaball<presets::KineticBlob>& m) { m.unwrap().m_center = glm::vec3(std::numeric_limits<float>::infinity()); });
+    engine.construct_mesh();
+    const IndexDim after_infinity = engine.get_field().shape();
+    engine.update_metaball(engine.handle_of(0), [](Metaball<presets::KineticBlob>& m) { m.unwrap().m_center = glm::vec3(1e30f); });
+    engine.construct_mesh();
+    const IndexDim after_huge = engine.get_field().shape();
+
+    std::cout << "\t" << fitted.x << " -> " << far.x << " nodes along x" << std::endl;
+    return glm::all(glm::lessThanEqual(fitted, IndexDim(MAX_PARTITIONS + 1))) && far == IndexDim(MAX_PARTITIONS + 1, fitted.y, fitted.z)
+        && after_nan == far && after_infinity == far && after_huge == far;
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Rectangular Layout #1", rectangular_layout_test },
+        { "Fitted Matches Cube #1", fitted_matches_cube_test },
+        { "Fitted Cost #1", fitted_cost_test },
+        { "Storage Reused #1", storage_reused_test },
+        { "Moving Fit #1", moving_fit_test },
+        { "Bounded Fit #1", bounded_fit_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nFIELD FIT TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
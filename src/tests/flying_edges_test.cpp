@@ -0,0 +1,96 @@
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+#include "test_scenes.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace mbl;
+using namespace test_scenes;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+// Same triangles, in the same winding, as the per-cell marching cubes
+bool matches_marching_cubes_test() {
+    KineticEngine flying = make_still_engine(ExtractionBackend::FlyingEdges, 1);
+    KineticEngine marched = make_still_engine(ExtractionBackend::MarchingCubes, 1);
+    for (KineticEngine* engine : { &flying, &marched }) {
+        engine->add_metaball(Metaball(presets::KineticBlob(glm::vec3(4.8f, 4.7f, -4.9f))));    // cut open by the field's edges
+    }
+    const common::graphics::MeshData& a = flying.construct_mesh();
+    return !a.indices.empty() && same_triangles(a, marched.construct_mesh());
+}
+
+// Every edge of the mesh is shared by exactly two triangles, once in each direction
+bool watertight_test() {
+    KineticEngine engine = make_still_engine(ExtractionBackend::FlyingEdges, 1);
+    const common::graphics::MeshData& mesh = engine.construct_mesh();
+
+    std::map<std::pair<int32_t, int32_t>, int32_t> directed_edges;
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        for (size_t v = 0; v < 3; v++) {
+            directed_edges[{ mesh.indices[i + v], mesh.indices[i + (v + 1) % 3] }] += 1;
+        }
+    }
+
+    bool closed = !directed_edges.empty();
+    for (const auto& [edge, uses] : directed_edges) {
+        const auto opposite = directed_edges.find({ edge.second, edge.first });
+        closed = closed && uses == 1 && opposite != directed_edges.end() && opposite->second == 1;
+    }
+    return closed;
+}
+
+// Vertices are shared: a closed mesh has about half as many vertices as triangles
+bool shared_vertices_test() {
+    KineticEngine flying = make_still_engine(ExtractionBackend::FlyingEdges, 1);
+    KineticEngine marched = make_still_engine(ExtractionBackend::MarchingCubes, 1);
+    const size_t shared = flying.construct_mesh().vertices.size();
+    const size_t unshared = marched.construct_mesh().vertices.size();
+
+    std::cout << "\t" << unshared << " marching cubes vertices -> " << shared << " flying edges vertices" << std::endl;
+    return shared * 5 < unshared;
+}
+
+// Threads split the work but not the result
+bool threaded_test() {
+    KineticEngine single = make_still_engine(ExtractionBackend::FlyingEdges, 1, 160);
+    KineticEngine threaded = make_still_engine(ExtractionBackend::FlyingEdges, 4, 160);
+    const common::graphics::MeshData& a = single.construct_mesh();
+    const common::graphics::MeshData& b = threaded.construct_mesh();
+
+    bool equal = a.indices == b.indices && a.vertices.size() == b.vertices.size();
+    for (size_t i = 0; equal && i < a.vertices.size(); i++) {
+        equal = a.vertices[i].position == b.vertices[i].position && a.vertices[i].normal == b.vertices[i].normal;
+    }
+    return equal;
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Matches Marching Cubes #1", matches_marching_cubes_test },
+        { "Watertight #1", watertight_test },
+        { "Shared Vertices #1", shared_vertices_test },
+        { "Threaded #1", threaded_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nFLYING EDGES TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
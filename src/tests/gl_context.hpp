@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../dependencies/glfw-3.4/deps/glad/gl.h"
+#include "../dependencies/glfw-3.4/include/GLFW/glfw3.h"
+
+/** The OpenGL context tests that need one render into */
+namespace gl_context {
+    /** Return code telling ctest the test was skipped (no OpenGL context could be made) */
+    inline constexpr int SKIPPED = 77;
+
+    /** Makes a hidden window with a current OpenGL context. Tries the platform's own window system
+     * first, then GLFW's null platform (which renders through OSMesa or EGL, e.g. Mesa's llvmpipe). */
+    inline GLFWwindow* open_hidden_context() {
+        const int context_apis[] = { GLFW_NATIVE_CONTEXT_API, GLFW_OSMESA_CONTEXT_API, GLFW_EGL_CONTEXT_API };
+        const int platforms[] = { GLFW_ANY_PLATFORM, GLFW_PLATFORM_NULL };
+
+        for (const int platform : platforms) {
+            glfwInitHint(GLFW_PLATFORM, platform);
+            if (!glfwInit()) {
+                continue;
+            }
+
+            for (const int api : context_apis) {
+                glfwDefaultWindowHints();
+                glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+                glfwWindowHint(GLFW_CONTEXT_CREATION_API, api);
+                glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+                glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+                glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+                if (GLFWwindow* win = glfwCreateWindow(64, 64, "gl test", nullptr, nullptr)) {
+                    glfwMakeContextCurrent(win);
+                    if (gladLoadGL(glfwGetProcAddress)) {
+                        return win;
+                    }
+                    glfwDestroyWindow(win);
+                }
+            }
+            glfwTerminate();
+        }
+        return nullptr;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,410 @@
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mbl;
+using SceneEngine = MetaballEngine<AggregateMetaball>;
+using KineticEngine = MetaballEngine<Metaball<presets::KineticBlob>>;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+static constexpr int REPEATS = 5;
+static constexpr double TOLERANCE = 1e-4;         // relative, of fingerprint moments
+static constexpr double SLOWDOWN_LIMIT = 1.5;       // times past baseline * limit + slack fail
+static constexpr double SLACK_MS = 0.5;
+static constexpr double CHECKED_IN_SLOWDOWN_LIMIT = 4.0;  // the checked-in baselines were measured on another machine
+static constexpr double CHECKED_IN_SLACK_MS = 5.0;
+static constexpr uint32_t BOUNCING_SEED = 354;
+static constexpr int BOUNCING_FRAMES = 60;
+
+/** What a mesh is checked by: its triangle count & the moments of its surface, which don't depend on
+ * the order of triangles or vertices. Moments move with any vertex, but only by as much as it does,
+ * so rounding differences between compilers stay under the tolerance while real changes don't.
+ * The signed volume catches flipped winding. Triangles with a corner at a non-finite position (some
+ * scenes divide by zero at nodes) are counted but add no moments. */
+struct Fingerprint {
+    size_t triangles = 0;
+    double area = 0.0;
+    double volume = 0.0;
+    glm::dvec3 centroid = glm::dvec3(0.0);  // area weighted
+
+    Fingerprint& operator+=(const Fingerprint& f) {
+        triangles += f.triangles;
+        area += f.area;
+        volume += f.volume;
+        centroid += f.centroid;
+        return *this;
+    }
+
+    bool matches(const Fingerprint& golden) const {
+        const auto close = [](const double a, const double b) { return std::abs(a - b) <= TOLERANCE * (1.0 + std::abs(b)); };
+        return triangles == golden.triangles && close(area, golden.area) && close(volume, golden.volume)
+            && close(centroid.x, golden.centroid.x) && close(centroid.y, golden.centroid.y) && close(centroid.z, golden.centroid.z);
+    }
+};
+
+/** Fingerprints of every scene as of the last intended change to its output. If a change to
+ * extraction is meant to change a scene, replace its entry with the one the failing test prints. */
+static const std::map<std::string, Fingerprint> GOLDEN = {
+    { "scene0", { 3704, 12.5667197, -4.18223, glm::dvec3(-1.8228149e-17, 7.86046575e-18, 6.56178198e-09) } },
+    { "scene1", { 5100, 17.3011542, -3.40054357, glm::dvec3(8.05204415, 18.3394034, 12.9123172) } },
+    { "scene2", { 4232, 17.6109494, -6.4940484, glm::dvec3(-1.81061763e-17, 1.17310675e-16, -5.28514037e-09) } },
+    { "scene3", { 6336, 23.0541775, -9.42425777, glm::dvec3(31.5644692, 31.7120819, 31.8281353) } },
+    { "scene4", { 24526, 77.3808305, 2.3191594, glm::dvec3(8.06003551, 8.05877442, 8.05880425) } },
+    { "scene5", { 10604, 38.4605877, -17.3196964, glm::dvec3(1.72214839, 35.0706852, 21.6275069) } },
+    { "scene6", { 33716, 126.788027, -0.212049166, glm::dvec3(1.45527998e-07, 21.2774722, -1.18446919e-14) } },
+    { "scene7", { 9768, 38.4960645, -8.89968368, glm::dvec3(0.000180490309, 12.6551441, 3.38920021e-05) } },
+    { "scene8", { 23590, 78.3076049, -14.3734687, glm::dvec3(17.3839128, 86.1371163, -2.64923321) } },
+    { "scene9", { 22560, 85.2467489, -48.068143, glm::dvec3(6.9388939e-17, 3.90312782e-16, -5.23019128e-15) } },
+    { "bouncing", { 309820, 11549.8546, -6052.88304, glm::dvec3(1840.8177, 15057.5829, 2448.44083) } }
+};
+
+/** Median milliseconds of every scene on a single core x86-64 machine, for builds with & without
+ * `NDEBUG` (CMake's Release & Debug). Timings are checked against these, loosely, when no baseline
+ * file is given. If a change is meant to make a scene slower, update its entry. */
+#ifdef NDEBUG
+static constexpr const char* CONFIGURATION = "NDEBUG";
+static const std::map<std::string, double> CHECKED_IN_BASELINE = {
+    { "scene0", 4.4 }, { "scene1", 8.9 }, { "scene2", 28.8 }, { "scene3", 34.5 }, { "scene4", 28.2 },
+    { "scene5", 74.8 }, { "scene6", 17.8 }, { "scene7", 8.0 }, { "scene8", 35.8 }, { "scene9", 7.6 },
+    { "bouncing", 391.8 }
+};
+#else
+static constexpr const char* CONFIGURATION = "debug";
+static const std::map<std::string, double> CHECKED_IN_BASELINE = {
+    { "scene0", 68.1 }, { "scene1", 187.2 }, { "scene2", 69.7 }, { "scene3", 144.0 }, { "scene4", 130.4 },
+    { "scene5", 261.6 }, { "scene6", 269.2 }, { "scene7", 141.0 }, { "scene8", 325.1 }, { "scene9", 94.3 },
+    { "bouncing", 8730.7 }
+};
+#endif
+
+static const char* baseline_path = nullptr;     // a per machine baseline, checked tightly when given
+static bool record_baseline = false;
+static std::map<std::string, double> timings;
+
+static Fingerprint fingerprint(const common::graphics::MeshData& mesh) {
+    Fingerprint f;
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        const glm::dvec3 a = mesh.vertices[mesh.indices[i]].position;
+        const glm::dvec3 b = mesh.vertices[mesh.indices[i + 1]].position;
+        const glm::dvec3 c = mesh.vertices[mesh.indices[i + 2]].position;
+        f.triangles += 1;
+        if (!std::isfinite(glm::dot(a + b + c, glm::dvec3(1.0)))) {
+            continue;
+        }
+
+        const double area = 0.5 * glm::length(glm::cross(b - a, c - a));
+        f.area += area;
+        f.volume += glm::dot(a, glm::cross(b, c)) / 6.0;
+        f.centroid += area * (a + b + c) / 3.0;
+    }
+    return f;
+}
+
+/** A metaball of the scene viewer: `f(center, point)` around `center`, as `main.cpp`'s `tune_*` functions build them */
+template <typename F>
+static AggregateMetaball ball(const glm::vec3& center, F f) {
+    return AggregateMetaball([center, f](float x, float y, float z) { return f(center, glm::vec3(x, y, z)); });
+}
+
+static auto blob(const float c1 = 1.f, const float c2 = 1.f, const float c3 = 1.f) {
+    return [c1, c2, c3](const glm::vec3& c, const glm::vec3& p) {
+        return 1.f / (c1 * (float) std::pow(c.x - p.x, 2) + c2 * (float) std::pow(c.y - p.y, 2) + c3 * (float) std::pow(c.z - p.z, 2));
+    };
+}
+
+static auto cube() {
+    return [](const glm::vec3& c, const glm::vec3& p) {
+        return 1.f / ((float) std::pow(c.x - p.x, 4) + (float) std::pow(c.y - p.y, 4) + (float) std::pow(c.z - p.z, 4));
+    };
+}
+
+static auto gyroid(const float a1 = 1.f, const float a2 = 1.f, const float a3 = 1.f) {
+    return [a1, a2, a3](const glm::vec3&, const glm::vec3& p) {
+        return a1 * std::sin(p.x) * std::cos(p.y) + a2 * std::sin(p.y) * std::cos(p.z) + a3 * std::sin(p.z) * std::cos(p.x);
+    };
+}
+
+static auto cross(const float c1, const float c2, const float c3) {
+    return [c1, c2, c3](const glm::vec3& c, const glm::vec3& p) {
+        return c1 / (float) std::pow(c.x - p.x, 2) + c2 / (float) std::pow(c.y - p.y, 2) + c3 / (float) std::pow(c.z - p.z, 2);
+    };
+}
+
+static auto plane(const float c1, const float c2, const float c3, const float offset = 1.f) {
+    return [c1, c2, c3, offset](const glm::vec3& c, const glm::vec3& p) {
+        return c1 * (c.x - p.x) + c2 * (c.y - p.y) + c3 * (c.z - p.z) + offset;
+    };
+}
+
+static auto star(const float scale) {
+    return [scale](const glm::vec3& c, const glm::vec3& p) {
+        return scale / std::abs((c.x - p.x) * (c.y - p.y));
+    };
+}
+
+static auto paraboloid() {
+    return [](const glm::vec3& c, const glm::vec3& p) {
+        return (float) std::abs(1.f / (std::pow(c.x - p.x, 2) + std::pow(c.z - p.z, 2) + (c.y - p.y)));
+    };
+}
+
+/** The ten scenes of `setup_scenes` in `main.cpp`: a 6 unit cube of 60 cells per axis around the
+ * origin, at isovalue 1 */
+static SceneEngine make_scene(const int scene) {
+    SceneEngine m(glm::vec3(0.f), 6.f, 60, 1.f);
+    switch (scene) {
+        case 0:
+            m.add_metaball(ball(glm::vec3(0.f), blob()));
+            break;
+        case 1:
+            m.add_metaball(ball(glm::vec3(0.f), blob(2.f, 5.f, 1.f)));
+            m.add_metaball(ball(glm::vec3(1.7f), blob(8.f, 2.f, 2.f)));
+            m.add_metaball(ball(glm::vec3(0.f, 2.f, 0.9f), blob(10.f, 1.5f, 2.f)));
+            break;
+        case 2:
+            m.add_metaball(ball(glm::vec3(0.f), cube()));
+            break;
+        case 3:
+            m.add_metaball(ball(glm::vec3(1.2f), cube()));
+            m.add_metaball(ball(glm::vec3(1.9f), blob(1.f, 2.f, 3.f)));
+            break;
+        case 4:
+            m.add_metaball(ball(glm::vec3(0.f), gyroid()));
+            break;
+        case 5:
+            m.add_metaball(ball(glm::vec3(0.f), blob()));
+            m.add_metaball(ball(glm::vec3(0.4f, 0.5f, 0.1f), cube()));
+            m.add_metaball(ball(glm::vec3(-0.3f, 2.1f, 1.4f), cube()));
+            break;
+        case 6:
+            m.add_metaball(ball(glm::vec3(0.f), cross(0.05f, 0.05f, 0.f)));
+            m.add_metaball(ball(glm::vec3(0.f), plane(0.f, 1.f, 0.f, 0.f)));
+            break;
+        case 7:
+            m.add_metaball(ball(glm::vec3(0.f, 0.5f, 0.f), blob()));
+            m.add_metaball(ball(glm::vec3(0.f), plane(0.f, 1.f, 0.f, 1.f)));
+            break;
+        case 8:
+            m.add_metaball(ball(glm::vec3(0.f), gyroid(0.f, 0.f, 1.f)));
+            m.add_metaball(ball(glm::vec3(0.5f, 0.f, 0.f), paraboloid()));
+            m.add_metaball(ball(glm::vec3(0.f), plane(0.f, 1.f, 0.f)));
+            break;
+        default:
+            m.add_metaball(ball(glm::vec3(0.f), star(2.f)));
+            break;
+    }
+    return m;
+}
+
+/** Uniform float in [low, high) from the raw generator output, which unlike the standard
+ * distributions is the same on every standard library */
+static float uniform(std::mt19937& rng, const float low, const float high) {
+    return low + (high - low) * (float) ((double) rng() / 4294967296.0);
+}
+
+/** The `-b` bouncing scene with its blobs placed from `BOUNCING_SEED`, stepped at 30 frames a second.
+ * Returns the summed fingerprints of every frame's mesh & the milliseconds spent meshing them. */
+static Fingerprint run_bouncing(double& ms) {
+    KineticEngine engine(glm::vec3(0.f), 10.f, 30, 1.f);
+    engine.set_extraction_mode(ExtractionMode::Tracking);
+    engine.set_auto_fit(10.f / 30.f, 1.f);
+
+    std::mt19937 rng(BOUNCING_SEED);
+    for (int i = 0; i < 10; i++) {
+        const glm::vec3 position(uniform(rng, -5.f, 5.f), uniform(rng, -5.f, 5.f), uniform(rng, -5.f, 5.f));
+        glm::vec3 velocity(0.f);
+        while (glm::length(velocity) < 0.1f || glm::length(velocity) > 1.f) {
+            velocity = glm::vec3(uniform(rng, -1.f, 1.f), uniform(rng, -1.f, 1.f), uniform(rng, -1.f, 1.f));
+        }
+        engine.add_metaball(Metaball(presets::KineticBlob(position, glm::normalize(velocity))));
+    }
+
+    Fingerprint frames;
+    ms = 0.0;
+    for (int frame = 0; frame < BOUNCING_FRAMES; frame++) {
+        engine.clear_changes();
+        for (size_t i = 0; i < engine.num_metaballs(); i++) {
+            engine.update_metaball(engine.handle_of(i), [](Metaball<presets::KineticBlob>& m) {
+                presets::KineticBlob& kb = m.unwrap();
+                glm::vec3& kb_pos = kb.update(1.f / 30.f);
+                for (int a = 0; a < 3; a++) {
+                    if (kb_pos[a] < -4.f || kb_pos[a] > 4.f) {
+                        kb_pos[a] = kb_pos[a] < 0.f ? -4.f : 4.f;
+                        kb.m_velocity[a] *= -1;
+                    }
+                }
+            });
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const common::graphics::MeshData& mesh = engine.construct_mesh();
+        ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        frames += fingerprint(mesh);
+    }
+    return frames;
+}
+
+static double median(std::vector<double> times) {
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+static bool check_golden(const std::string& name, const Fingerprint& f, const double ms) {
+    timings[name] = ms;
+    const auto golden = GOLDEN.find(name);
+    const bool matches = golden != GOLDEN.end() && f.matches(golden->second);
+
+    std::cout << "\t" << f.triangles << " triangles, " << ms << " ms";
+    if (!matches) {
+        std::cout.precision(9);
+        std::cout << ", differs from the golden value, measured:\n\t{ \"" << name << "\", { " << f.triangles << ", " << f.area << ", "
+            << f.volume << ", glm::dvec3(" << f.centroid.x << ", " << f.centroid.y << ", " << f.centroid.z << ") } }";
+        std::cout.precision(6);
+    }
+    std::cout << std::endl;
+    return matches && f.triangles > 0;
+}
+
+template <int SCENE>
+bool golden_scene_test() {
+    Fingerprint f;
+    bool stable = true;
+    std::vector<double> times;
+    for (int i = 0; i < REPEATS; i++) {
+        SceneEngine engine = make_scene(SCENE);
+        const auto start = std::chrono::steady_clock::now();
+        const common::graphics::MeshData& mesh = engine.construct_mesh();
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+        const Fingerprint repeat = fingerprint(mesh);
+        stable = stable && (i == 0 || repeat.matches(f));
+        f = repeat;
+    }
+    return check_golden("scene" + std::to_string(SCENE), f, median(times)) && stable;
+}
+
+// The bouncing scene meshes the same every run from the same seed
+bool bouncing_test() {
+    Fingerprint f;
+    bool stable = true;
+    std::vector<double> times;
+    for (int i = 0; i < REPEATS; i++) {
+        double ms = 0.0;
+        const Fingerprint repeat = run_bouncing(ms);
+        stable = stable && (i == 0 || repeat.matches(f));
+        f = repeat;
+        times.push_back(ms);
+    }
+    return check_golden("bouncing", f, median(times)) && stable;
+}
+
+/** True if every timing is within `slowdown` times its entry in `baseline` plus `slack` */
+static bool within_baseline(const std::map<std::string, double>& baseline, const double slowdown, const double slack) {
+    bool within = true;
+    for (const auto& [scene, scene_ms] : timings) {
+        const auto it = baseline.find(scene);
+        if (it == baseline.end()) {
+            std::cout << "\t" << scene << " has no baseline" << std::endl;
+            within = false;
+            continue;
+        }
+        const double limit = it->second * slowdown + slack;
+        if (scene_ms > limit) {
+            std::cout << "\t" << scene << " took " << scene_ms << " ms, baseline " << it->second << " ms (limit " << limit << " ms)" << std::endl;
+            within = false;
+        }
+    }
+    return within;
+}
+
+/** Compares the timings of the other tests with the baseline file, or writes it with `--record`. A
+ * missing or empty baseline file fails unless recording. Without a file, the timings are checked
+ * against the checked-in baseline of this build configuration, loosely since it's another machine's. */
+bool timings_test() {
+    if (baseline_path == nullptr) {
+        std::cout << "\tno baseline file given, checking against the checked-in " << CONFIGURATION
+            << " baseline (" << CHECKED_IN_SLOWDOWN_LIMIT << "x)" << std::endl;
+        return within_baseline(CHECKED_IN_BASELINE, CHECKED_IN_SLOWDOWN_LIMIT, CHECKED_IN_SLACK_MS);
+    }
+
+    if (record_baseline) {
+        std::ofstream out(baseline_path);
+        for (const auto& [scene, scene_ms] : timings) {
+            out << scene << " " << scene_ms << "\n";
+        }
+        std::cout << "\trecorded baseline to " << baseline_path << std::endl;
+        return (bool) out;
+    }
+
+    std::map<std::string, double> baseline;
+    std::ifstream in(baseline_path);
+    std::string name;
+    double ms = 0.0;
+    while (in >> name >> ms) {
+        baseline[name] = ms;
+    }
+    if (baseline.empty()) {
+        std::cout << "\tNO BASELINE in " << baseline_path << ", run `gt " << baseline_path << " --record` to record one" << std::endl;
+        return false;
+    }
+    return within_baseline(baseline, SLOWDOWN_LIMIT, SLACK_MS);
+}
+
+/** `gt [baseline file] [--record]`: meshes every scene against its golden fingerprint, then checks the
+ * timings against the baseline file if one is given (writing it with `--record`), otherwise loosely
+ * against the checked-in baseline */
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--record") == 0) {
+            record_baseline = true;
+        } else {
+            baseline_path = argv[i];
+        }
+    }
+
+    TestItem tests[] = {
+        { "Golden Scene #0", golden_scene_test<0> },
+        { "Golden Scene #1", golden_scene_test<1> },
+        { "Golden Scene #2", golden_scene_test<2> },
+        { "Golden Scene #3", golden_scene_test<3> },
+        { "Golden Scene #4", golden_scene_test<4> },
+        { "Golden Scene #5", golden_scene_test<5> },
+        { "Golden Scene #6", golden_scene_test<6> },
+        { "Golden Scene #7", golden_scene_test<7> },
+        { "Golden Scene #8", golden_scene_test<8> },
+        { "Golden Scene #9", golden_scene_test<9> },
+        { "Bouncing #1", bouncing_test },
+        { "Timings #1", timings_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nGOLDEN SCENE TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
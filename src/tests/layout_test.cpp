@@ -0,0 +1,121 @@
+#include <isosurface.hpp>
+#include <marcher.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace mbl;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+static const IndexDim PARTITIONS = IndexDim(9, 6, 13);  // no axis a whole number of bricks
+
+static IsoSurface make_field(const NodeLayout layout) {
+    IsoSurface field = IsoSurface::construct(glm::vec3(0.5f, -1.f, 2.f), glm::vec3(3.f, 2.f, 4.f), PARTITIONS, layout);
+    const IndexDim shape = field.shape();
+    for (int32_t z = 0; z < shape.z; z++) {
+        for (int32_t y = 0; y < shape.y; y++) {
+            for (int32_t x = 0; x < shape.x; x++) {
+                IsoPoint& point = field.get(x, y, z);
+                point.density = std::sin(point.position.x) + point.position.y * point.position.z;
+            }
+        }
+    }
+    return field;
+}
+
+// Every point gets its own slot & unflattens back to where it came from
+bool round_trip_test() {
+    bool round_trip = true;
+    for (const NodeLayout layout : { NodeLayout::Linear, NodeLayout::Bricked }) {
+        const IndexCompactor compactor(PARTITIONS + 1, layout);
+        std::vector<int32_t> uses(compactor.size(), 0);
+        for (int32_t z = 0; z <= PARTITIONS.z; z++) {
+            for (int32_t y = 0; y <= PARTITIONS.y; y++) {
+                for (int32_t x = 0; x <= PARTITIONS.x; x++) {
+                    const int32_t i = compactor.flatten(x, y, z);
+                    const int32_t summed = compactor.flatten_at(x, 0) + compactor.flatten_at(y, 1) + compactor.flatten_at(z, 2);
+                    round_trip = round_trip && i >= 0 && (size_t) i < uses.size() && i == summed
+                        && compactor.unflatten(i) == IndexDim(x, y, z);
+                    if (round_trip) {
+                        uses[i] += 1;
+                    }
+                }
+            }
+        }
+        for (const int32_t u : uses) {
+            round_trip = round_trip && u <= 1;
+        }
+    }
+    return round_trip && IndexCompactor(PARTITIONS + 1, NodeLayout::Bricked).size() == 12 * 8 * 16;
+}
+
+// A bricked field holds the same points as a linear one, wherever they're stored
+bool same_points_test() {
+    const IsoSurface linear = make_field(NodeLayout::Linear);
+    const IsoSurface bricked = make_field(NodeLayout::Bricked);
+    const IndexDim shape = linear.shape();
+
+    bool same = bricked.layout() == NodeLayout::Bricked && bricked.indices() > linear.indices();
+    for (int32_t z = 0; z < shape.z; z++) {
+        for (int32_t y = 0; y < shape.y; y++) {
+            for (int32_t x = 0; x < shape.x; x++) {
+                const IsoPoint& a = linear.get(x, y, z);
+                const IsoPoint& b = bricked.get(x, y, z);
+                same = same && a.position == b.position && a.density == b.density;
+            }
+        }
+    }
+    return same;
+}
+
+// Marching cube ranges & their views see the same cubes in the same order on either layout
+bool cube_views_test() {
+    IsoSurface linear = make_field(NodeLayout::Linear);
+    IsoSurface bricked = make_field(NodeLayout::Bricked);
+    MarchingCubeRange a(linear);
+    MarchingCubeRange b(bricked);
+
+    bool same = true;
+    size_t cubes = 0;
+    MarchingCubeRange::iterator it_b = b.begin();
+    for (MarchingCubeRange::iterator it_a = a.begin(); it_a != a.end(); ++it_a, ++it_b) {
+        CubeView view_a = *it_a;
+        CubeView view_b = *it_b;
+        for (int32_t c = 0; c < 8; c++) {
+            same = same && view_a.at(c).position == view_b.at(c).position && view_a.at(c).density == view_b.at(c).density;
+        }
+
+        CubeView::iterator corner_b = view_b.begin();
+        for (const IsoPoint& corner_a : view_a) {
+            same = same && corner_a.position == corner_b->position;
+            ++corner_b;
+        }
+        cubes += 1;
+    }
+    return same && it_b == b.end() && cubes == (size_t) PARTITIONS.x * PARTITIONS.y * PARTITIONS.z;
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Round Trip #1", round_trip_test },
+        { "Same Points #1", same_points_test },
+        { "Cube Views #1", cube_views_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nNODE LAYOUT TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
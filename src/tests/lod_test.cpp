@@ -0,0 +1,161 @@
+#include <engine.hpp>
+#include <lod.hpp>
+#include <metaball_presets.hpp>
+#include "test_scenes.hpp"
+
+#include <cmath>
+#include <iostream>
+
+using namespace mbl;
+using namespace test_scenes;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+static constexpr int32_t RESOLUTION = 80;
+
+/** Outward normal of `engine`'s surface at `p`, by central differences */
+static glm::vec3 surface_normal(const KineticEngine& engine, const glm::vec3& p) {
+    const float eps = 1e-3f;
+    return -glm::normalize(glm::vec3(
+        engine.sum_metaballs(p + glm::vec3(eps, 0.f, 0.f)) - engine.sum_metaballs(p - glm::vec3(eps, 0.f, 0.f)),
+        engine.sum_metaballs(p + glm::vec3(0.f, eps, 0.f)) - engine.sum_metaballs(p - glm::vec3(0.f, eps, 0.f)),
+        engine.sum_metaballs(p + glm::vec3(0.f, 0.f, eps)) - engine.sum_metaballs(p - glm::vec3(0.f, 0.f, eps))
+    ));
+}
+
+// Subsampled fields hold exactly the fine field's nodes
+bool subsample_test() {
+    KineticEngine engine = make_engine(RESOLUTION);
+    const IsoSurface& fine = engine.get_complete_field();
+    IsoSurface coarse = IsoSurface::subsample(fine, 4);
+
+    const int32_t n = fine.shape().x;
+    const int32_t m = coarse.shape().x;
+    bool exact = m == 21;
+    for (int32_t z = 0; exact && z < m; z++) {
+        for (int32_t y = 0; y < m; y++) {
+            for (int32_t x = 0; x < m; x++) {
+                const IsoPoint& a = coarse.data()[x + y * m + z * m * m];
+                const IsoPoint& b = fine.data()[4 * (x + y * n + z * n * n)];
+                exact = exact && a.position == b.position && a.density == b.density;
+            }
+        }
+    }
+    return exact;
+}
+
+// Each level has about a quarter of the triangles of the one before, all on the surface
+bool triangle_counts_test() {
+    KineticEngine engine = make_engine(RESOLUTION);
+    LodMeshSet<Metaball<presets::KineticBlob>> lods(engine);
+
+    bool fewer = lods.level_count() == 3;
+    size_t previous = 0;
+    for (size_t level = 0; level < lods.level_count(); level++) {
+        const common::graphics::MeshData& mesh = lods.mesh(engine, level);
+        const size_t triangles = mesh.indices.size() / 3;
+        std::cout << "\tlevel " << level << ": " << triangles << " triangles" << std::endl;
+        fewer = fewer && (level == 0 || (triangles * 3 < previous && triangles * 6 > previous));
+        previous = triangles;
+
+        // Coarse vertices still sit close to the isosurface, normals close to the surface's
+        for (size_t i = 0; level > 0 && i < mesh.vertices.size(); i++) {
+            const common::graphics::Vertex& v = mesh.vertices[i];
+            fewer = fewer && std::fabs(engine.sum_metaballs(v.position) - 1.f) < 0.1f
+                && glm::dot(v.normal, surface_normal(engine, v.position)) > 0.9f;
+        }
+    }
+    return fewer;
+}
+
+// A camera wobbling around a switch distance doesn't flip levels, one moving far past it does
+bool hysteresis_test() {
+    KineticEngine engine = make_engine(RESOLUTION);
+    LodMeshSet<Metaball<presets::KineticBlob>> lods(engine);
+    lods.set_switch_distances({ 20.f, 40.f });
+
+    // Field spans [-5, 5]
+    auto at = [](const float distance) { return glm::vec3(5.f + distance, 0.f, 0.f); };
+    bool stable = lods.select(engine, at(5.f)) == 0 && lods.select(engine, at(21.f)) == 0 && lods.select(engine, at(23.f)) == 1;
+    for (const float distance : { 19.f, 21.f, 19.5f, 22.5f }) {
+        stable = stable && lods.select(engine, at(distance)) == 1;
+    }
+    stable = stable && lods.select(engine, at(17.f)) == 0 && lods.select(engine, at(100.f)) == 2 && lods.select(engine, at(0.f)) == 0;
+    return stable;
+}
+
+// Coarse meshes are reused until the field or isovalue changes
+bool cache_test() {
+    KineticEngine engine = make_engine(RESOLUTION);
+    LodMeshSet<Metaball<presets::KineticBlob>> lods(engine);
+
+    const common::graphics::MeshData first = lods.mesh(engine, 2);
+    const uint64_t revision = engine.get_field_revision();
+    const bool reused = lods.mesh(engine, 2).indices == first.indices && engine.get_field_revision() == revision;
+
+    engine.update_metaball(engine.handle_of(0), [](Metaball<presets::KineticBlob>& m) { m.unwrap().m_center += glm::vec3(1.f, 0.f, 0.f); });
+    const bool moved = lods.mesh(engine, 2).vertices.size() != first.vertices.size() || lods.mesh(engine, 2).vertices[0].position != first.vertices[0].position;
+
+    engine.set_isovalue(1.5f);
+    const size_t before = lods.mesh(engine, 2).indices.size();
+    return reused && moved && engine.get_field_revision() == revision + 1 && before < first.indices.size();
+}
+
+// Under auto-fit the levels follow the field as it changes shape, matching levels made for each new field
+bool auto_fit_test() {
+    KineticEngine engine = make_engine(RESOLUTION);
+    engine.set_auto_fit(0.125f, 0.5f);
+    LodMeshSet<Metaball<presets::KineticBlob>> lods(engine);
+
+    bool followed = true;
+    size_t coarse_frames = 0;
+    size_t shapes = 0;
+    IndexDim last_shape = engine.get_field().shape();
+    for (int frame = 0; frame < 60; frame++) {
+        step(engine, 0.05f);
+        const common::graphics::MeshData& mesh = lods.mesh(engine, 2);
+        const IsoSurface& field = engine.get_field();
+        shapes += (size_t) (field.shape() != last_shape);
+        last_shape = field.shape();
+
+        LodMeshSet<Metaball<presets::KineticBlob>> fresh(engine);
+        followed = followed && lods.level_count() == fresh.level_count();
+        if (fresh.level_count() > 1) {
+            coarse_frames += 1;
+            followed = followed && triangles_of(mesh) == triangles_of(fresh.mesh(engine, 2));
+        }
+
+        const glm::vec3 low = field.min_corner() - 1e-4f;
+        const glm::vec3 high = field.min_corner() + 2.f * field.half_extents() + 1e-4f;
+        for (const common::graphics::Vertex& v : mesh.vertices) {
+            followed = followed && glm::all(glm::greaterThanEqual(v.position, low)) && glm::all(glm::lessThanEqual(v.position, high));
+        }
+    }
+    std::cout << "\t" << shapes << " field shapes, " << coarse_frames << " frames with coarse levels" << std::endl;
+    return followed && shapes > 10 && coarse_frames > 0 && coarse_frames < 60;
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Subsample #1", subsample_test },
+        { "Triangle Counts #1", triangle_counts_test },
+        { "Hysteresis #1", hysteresis_test },
+        { "Cache #1", cache_test },
+        { "Auto Fit #1", auto_fit_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nLEVEL OF DETAIL TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,109 @@
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+#include <occupancy.hpp>
+#include <scanline.hpp>
+#include "test_scenes.hpp"
+
+#include <iostream>
+#include <vector>
+
+using namespace mbl;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+// Rows of 131 nodes span three words, so word edges are crossed
+static constexpr int32_t RESOLUTION = 130;
+static constexpr float ISOVALUE = 1.f;
+
+static IsoSurface make_field() {
+    test_scenes::KineticEngine engine = test_scenes::make_engine(RESOLUTION);
+    engine.add_metaball(Metaball(presets::KineticBlob(glm::vec3(4.8f, -2.f, 1.f))));   // reaches the +x edge
+    engine.update_densities();
+    return engine.get_field();
+}
+
+// Bits & popcount match the densities node for node
+bool count_test() {
+    const IsoSurface field = make_field();
+    OccupancyVolume occupancy;
+    occupancy.build(field, ISOVALUE);
+
+    const IndexDim shape = field.shape();
+    size_t inside = 0;
+    bool equal = true;
+    for (int32_t z = 0; z < shape.z; z++) {
+        for (int32_t y = 0; y < shape.y; y++) {
+            for (int32_t x = 0; x < shape.x; x++) {
+                const bool expected = field.get(field.compactor().flatten(x, y, z)).density >= ISOVALUE;
+                inside += (size_t) expected;
+                equal = equal && occupancy.test(x, y, z) == expected;
+            }
+        }
+    }
+    return equal && inside > 0 && occupancy.count() == inside && occupancy.built_for(ISOVALUE);
+}
+
+// Case bytes built from bits match the ones built from densities, crossed cells only
+bool case_bytes_test() {
+    const IsoSurface field = make_field();
+    OccupancyVolume occupancy;
+    occupancy.build(field, ISOVALUE);
+    ScanlineClassifier classifier;
+
+    const int32_t n = field.shape().x;
+    std::vector<uint8_t> cases(n - 1);
+    std::vector<uint8_t> from_bits(n - 1);
+    bool equal = true;
+    size_t crossed = 0;
+    for (int32_t z = 0; z + 1 < n; z++) {
+        for (int32_t y = 0; y + 1 < n; y++) {
+            std::fill(from_bits.begin(), from_bits.end(), 0x0);
+            occupancy.for_each_crossed_cell(y, z, [&](const int32_t x, const uint8_t cube_bits) { from_bits[x] = cube_bits; crossed += 1; });
+
+            if (!classifier.classify_row(field.data() + y * n + z * n * n, n, n, n * n, ISOVALUE, cases.data())) {
+                std::fill(cases.begin(), cases.end(), 0x0);
+            }
+            for (int32_t x = 0; x + 1 < n; x++) {
+                const uint8_t expected = cases[x] == 0xFF ? 0x0 : cases[x];
+                equal = equal && from_bits[x] == expected;
+            }
+        }
+    }
+    return equal && crossed > 0;
+}
+
+// Boxes around empty space & deep inside a blob are uniform, boxes through the surface aren't
+bool uniform_test() {
+    const IsoSurface field = make_field();
+    OccupancyVolume occupancy;
+    occupancy.build(field, ISOVALUE);
+
+    const int32_t last = field.shape().x - 1;
+    const int32_t mid = last / 2;
+    return occupancy.uniform(IndexDim(0), IndexDim(8))                                  // empty corner
+        && occupancy.uniform(IndexDim(mid - 30, mid - 2, mid - 2), IndexDim(mid - 22, mid + 2, mid + 2))   // inside the -x blob
+        && !occupancy.uniform(IndexDim(0, mid - 10, mid - 10), IndexDim(last, mid + 10, mid + 10));
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Count #1", count_test },
+        { "Case Bytes #1", case_bytes_test },
+        { "Uniform #1", uniform_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nOCCUPANCY TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,112 @@
+#include <frame_pipeline.hpp>
+#include <metaball_presets.hpp>
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <future>
+
+using namespace mbl;
+using KineticEngine = MetaballEngine<Metaball<presets::KineticBlob>>;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+static KineticEngine make_engine() {
+    KineticEngine engine(glm::vec3(0.f), 10.f, 20, 1.f);
+    for (int i = 0; i < 4; i++) {
+        const glm::vec3 position = glm::vec3(-3.f + 2.f * (float) i, 0.5f * (float) i, 0.f);
+        const glm::vec3 velocity = glm::vec3(0.f, 1.f, 0.5f);
+        engine.add_metaball(Metaball(presets::KineticBlob(position, velocity)));
+    }
+    return engine;
+}
+
+static void advance(std::vector<Metaball<presets::KineticBlob>>& balls, uint64_t) {
+    for (Metaball<presets::KineticBlob>& ball : balls) {
+        ball.unwrap().update(1.f / 60.f);
+    }
+}
+
+// Every frame is uploaded exactly once, in order, with a non-empty mesh
+bool frames_in_order_test() {
+    uint64_t expected_frame = 0;
+    bool in_order = true;
+    bool non_empty = true;
+
+    FramePipeline<Metaball<presets::KineticBlob>> pipeline(make_engine(), advance,
+        [&](const common::graphics::MeshData& mesh, uint64_t frame) {
+            in_order = in_order && frame == expected_frame;
+            non_empty = non_empty && !mesh.vertices.empty();
+            expected_frame += 1;
+        });
+
+    const PipelineStats stats = pipeline.run(20);
+    return in_order && non_empty && expected_frame == 20 && stats.upload.frames == 20;
+}
+
+// Simulation results are carried from one frame to the next
+bool scene_advances_test() {
+    KineticEngine engine = make_engine();
+    const glm::vec3 start = engine.get_metaball(0).unwrap().m_center;
+
+    FramePipeline<Metaball<presets::KineticBlob>> pipeline(std::move(engine), advance);
+    pipeline.run(30);
+
+    const glm::vec3 end = pipeline.get_scene()[0].unwrap().m_center;
+    return std::abs((end.y - start.y) - 0.5f) < 1e-3f;
+}
+
+// Uploading frame 0 & simulating frame 1 meet in the middle: each waits for the other to have
+// started, which only happens if the two stages run at the same time
+bool stages_overlap_test() {
+    const auto patience = std::chrono::seconds(10);
+    std::promise<void> simulating, uploading;
+    std::shared_future<void> simulate_started = simulating.get_future().share();
+    std::shared_future<void> upload_started = uploading.get_future().share();
+    bool simulate_met = false;
+    bool upload_met = false;
+
+    FramePipeline<Metaball<presets::KineticBlob>> pipeline(make_engine(),
+        [&](std::vector<Metaball<presets::KineticBlob>>& balls, uint64_t frame) {
+            advance(balls, frame);
+            if (frame == 1) {
+                simulating.set_value();
+                simulate_met = upload_started.wait_for(patience) == std::future_status::ready;
+            }
+        },
+        [&](const common::graphics::MeshData&, uint64_t frame) {
+            if (frame == 0) {
+                uploading.set_value();
+                upload_met = simulate_started.wait_for(patience) == std::future_status::ready;
+            }
+        });
+
+    const PipelineStats stats = pipeline.run(40);
+    const double serial_ms = stats.simulate.total_ms + stats.extract.total_ms + stats.upload.total_ms;
+    std::cout << "\tserial " << serial_ms << " ms, pipelined " << stats.wall_ms << " ms, "
+        << stats.frames_per_second() << " fps, mean latency " << stats.latency.mean_ms() << " ms" << std::endl;
+    return simulate_met && upload_met && stats.upload.frames == 40;
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Frames In Order #1", frames_in_order_test },
+        { "Scene Advances #1", scene_advances_test },
+        { "Stages Overlap #1", stages_overlap_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nPIPELINE TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+#include <quantized_isosurface.hpp>
+#include "test_scenes.hpp"
+
+#include <bit>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace mbl;
+using test_scenes::KineticEngine;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+static constexpr float ISOVALUE = 1.f;
+static constexpr float FIXED_RANGE = 1.f;
+
+/** The shared three blobs & a fourth, extracted with Flying Edges */
+static KineticEngine make_engine(const int32_t resolution) {
+    KineticEngine engine = test_scenes::make_engine(resolution);
+    engine.add_metaball(Metaball(presets::KineticBlob(glm::vec3(0.5f, 2.f, -1.5f))));
+    engine.set_extraction_backend(ExtractionBackend::FlyingEdges, 1);
+    return engine;
+}
+
+template <typename Density>
+static BasicIsoSurface<Density> like(const IsoSurface& field, const Density& density) {
+    return BasicIsoSurface<Density>::construct(field.get_origin(), field.half_extents(), field.shape() - 1, density);
+}
+
+// Half conversions round to nearest even & keep infinities, NaNs & subnormals
+bool half_conversion_test() {
+    bool exact = HalfDensity::to_half(1.f) == 0x3C00 && HalfDensity::to_half(-2.f) == 0xC000
+        && HalfDensity::to_half(65504.f) == 0x7BFF && HalfDensity::to_half(65520.f) == 0x7C00
+        && HalfDensity::to_half(std::numeric_limits<float>::infinity()) == 0x7C00
+        && HalfDensity::to_half(5.9604645e-8f) == 0x0001 && HalfDensity::to_half(2.9802322e-8f) == 0x0000
+        && HalfDensity::to_half(1.f + 1.f / 2048.f) == 0x3C00 && HalfDensity::to_half(1.f + 3.f / 2048.f) == 0x3C02
+        && std::isnan(HalfDensity::to_float(HalfDensity::to_half(std::numeric_limits<float>::quiet_NaN())));
+
+    // Every half survives a round trip through float
+    for (uint32_t h = 0; h < 0x10000; h++) {
+        const float f = HalfDensity::to_float((uint16_t) h);
+        exact = exact && (std::isnan(f) || HalfDensity::to_half(f) == h);
+    }
+
+#if defined(__FLT16_MANT_DIG__)
+    // & rounds like the compiler's own half type
+    for (uint32_t bits = 0; bits < 0x7F800000; bits += 0x1F3) {
+        const float f = std::bit_cast<float>(bits);
+        exact = exact && HalfDensity::to_half(f) == std::bit_cast<uint16_t>((_Float16) f)
+            && HalfDensity::to_half(-f) == std::bit_cast<uint16_t>((_Float16) -f);
+    }
+#endif
+    return exact;
+}
+
+// Stored densities stay on the same side of the reference however close to it they are
+bool sign_kept_test() {
+    const HalfDensity half { ISOVALUE };
+    const FixedDensity fixed { ISOVALUE, FIXED_RANGE };
+    bool kept = true;
+    for (const float offset : { 0.f, 1e-12f, -1e-12f, 1e-6f, -1e-6f, 0.25f, -0.25f, 100.f, -100.f }) {
+        const float density = ISOVALUE + offset;
+        const bool inside = density >= ISOVALUE;
+        kept = kept && (half.decode(half.encode(density)) >= ISOVALUE) == inside
+            && (fixed.decode(fixed.encode(density)) >= ISOVALUE) == inside;
+    }
+    kept = kept && half.decode(half.encode(std::numeric_limits<float>::infinity())) == std::numeric_limits<float>::infinity()
+        && fixed.decode(fixed.encode(100.f)) == ISOVALUE + FIXED_RANGE;
+    return kept;
+}
+
+// Fields of quantized densities classify every node as the float field does
+bool same_classification_test() {
+    KineticEngine engine = make_engine(64);
+    const IsoSurface& field = engine.get_complete_field();
+    BasicIsoSurface<HalfDensity> half = like(field, HalfDensity { ISOVALUE });
+    BasicIsoSurface<FixedDensity> fixed = like(field, FixedDensity { ISOVALUE, FIXED_RANGE });
+    engine.evaluate_field(half);
+    engine.evaluate_field(fixed);
+
+    OccupancyVolume expected, half_bits, fixed_bits;
+    expected.build(field, ISOVALUE);
+    half_bits.build(half, ISOVALUE);
+    fixed_bits.build(fixed, ISOVALUE);
+
+    bool same = expected.count() > 0 && half_bits.count() == expected.count() && fixed_bits.count() == expected.count();
+    const IndexDim shape = field.shape();
+    for (int32_t z = 0; z < shape.z; z++) {
+        for (int32_t y = 0; y < shape.y; y++) {
+            for (int32_t w = 0; w < expected.row_words(); w++) {
+                same = same && half_bits.row_bits(y, z)[w] == expected.row_bits(y, z)[w]
+                    && fixed_bits.row_bits(y, z)[w] == expected.row_bits(y, z)[w];
+            }
+        }
+    }
+    return same && half.indices() * sizeof(uint16_t) * 8 == field.indices() * sizeof(IsoPoint);
+}
+
+/** Largest & mean distance between the vertices of `a` & `b`, in cells, if they have the same
+ * triangles, -1 otherwise */
+static glm::vec2 vertex_error(const common::graphics::MeshData& a, const common::graphics::MeshData& b, const float cell) {
+    if (a.indices != b.indices || a.vertices.size() != b.vertices.size()) {
+        return glm::vec2(-1.f);
+    }
+
+    double largest = 0.0;
+    double sum = 0.0;
+    for (size_t v = 0; v < a.vertices.size(); v++) {
+        const double d = glm::length(a.vertices[v].position - b.vertices[v].position) / cell;
+        largest = std::max(largest, d);
+        sum += d;
+    }
+    return glm::vec2((float) largest, (float) (sum / std::max<size_t>(a.vertices.size(), 1)));
+}
+
+// Meshes of quantized fields have the float field's triangles, with vertices moved a small fraction of a cell
+bool vertex_precision_test() {
+    KineticEngine engine = make_engine(96);
+    const common::graphics::MeshData expected = engine.construct_mesh();
+    const float cell = engine.get_field().cell_size().x;
+
+    BasicIsoSurface<HalfDensity> half = like(engine.get_field(), HalfDensity { ISOVALUE });
+    BasicIsoSurface<FixedDensity> fixed = like(engine.get_field(), FixedDensity { ISOVALUE, FIXED_RANGE });
+    common::graphics::MeshData half_mesh, fixed_mesh;
+    engine.construct_mesh(half, half_mesh);
+    engine.construct_mesh(fixed, fixed_mesh);
+
+    const glm::vec2 half_error = vertex_error(expected, half_mesh, cell);
+    const glm::vec2 fixed_error = vertex_error(expected, fixed_mesh, cell);
+    std::cout << "\t" << expected.vertices.size() << " vertices, half: " << half_error.x << " max / " << half_error.y
+        << " mean cells off, fixed: " << fixed_error.x << " max / " << fixed_error.y << " mean cells off" << std::endl;
+    return !expected.indices.empty() && half_error.x >= 0.f && half_error.x < 1e-3f && fixed_error.x >= 0.f && fixed_error.x < 2e-2f;
+}
+
+// A field meshed away from its reference still finds the surface, less precisely
+bool other_isovalue_test() {
+    KineticEngine engine = make_engine(64);
+    engine.set_isovalue(0.8f);
+    const common::graphics::MeshData expected = engine.construct_mesh();
+
+    BasicIsoSurface<HalfDensity> half = like(engine.get_field(), HalfDensity { ISOVALUE });
+    common::graphics::MeshData half_mesh;
+    engine.construct_mesh(half, half_mesh);
+
+    const glm::vec2 error = vertex_error(expected, half_mesh, engine.get_field().cell_size().x);
+    std::cout << "\thalf: " << error.x << " max cells off" << std::endl;
+    return !expected.indices.empty() && error.x >= 0.f && error.x < 0.05f;
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Half Conversion #1", half_conversion_test },
+        { "Sign Kept #1", sign_kept_test },
+        { "Same Classification #1", same_classification_test },
+        { "Vertex Precision #1", vertex_precision_test },
+        { "Other Isovalue #1", other_isovalue_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nQUANTIZED FIELD TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
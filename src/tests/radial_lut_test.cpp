@@ -0,0 +1,208 @@
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+#include <radial_lut.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace mbl;
+using presets::RadialLUTMetaball;
+using presets::RadialTable;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+static constexpr float ISOVALUE = 1.f;
+static constexpr float CUTOFF = 4.f;
+static constexpr float INNER = 0.1f;
+
+static std::shared_ptr<const RadialTable> inverse_square_table() {
+    return std::make_shared<const RadialTable>([](const float q) { return 1.f / q; }, CUTOFF, 4096, INNER);
+}
+
+static std::shared_ptr<const RadialTable> gaussian_table(const float variance) {
+    return std::make_shared<const RadialTable>([variance](const float q) { return expf(-q / (2 * variance)); }, CUTOFF, 1024);
+}
+
+static std::vector<glm::vec3> random_points(const size_t n, const float half_extent) {
+    std::mt19937 rng(49);
+    std::uniform_real_distribution<float> coordinate(-half_extent, half_extent);
+    std::vector<glm::vec3> points(n);
+    for (glm::vec3& p : points) {
+        p = glm::vec3(coordinate(rng), coordinate(rng), coordinate(rng));
+    }
+    return points;
+}
+
+// Tables stay within their reported error of the profile, read 0 past the cutoff & clamp inside the inner radius
+bool table_error_test() {
+    const std::shared_ptr<const RadialTable> gaussian = gaussian_table(1.f);
+    const std::shared_ptr<const RadialTable> inverse = inverse_square_table();
+
+    bool within = gaussian->interpolation_error() > 0.f && gaussian->interpolation_error() < 1e-5f
+        && gaussian->max_error() == expf(-CUTOFF * CUTOFF / 2.f)
+        && inverse->lookup(0.f) == 1.f / (INNER * INNER) && inverse->lookup(CUTOFF * CUTOFF) == 0.f;
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> q_of(INNER * INNER, CUTOFF * CUTOFF);
+    for (int k = 0; k < 100000; k++) {
+        const float q = q_of(rng);
+        within = within && std::abs(gaussian->lookup(q) - expf(-q / 2.f)) <= gaussian->interpolation_error() * 1.01f
+            && std::abs(inverse->lookup(q) - 1.f / q) <= inverse->interpolation_error() * 1.01f;
+    }
+    std::cout << "\tgaussian error: " << gaussian->interpolation_error() << ", inverse square error: " << inverse->interpolation_error() << std::endl;
+    return within;
+}
+
+// Metaballs read from tables match the presets they sample, & `compute_batch` matches `operator()`
+bool matches_presets_test() {
+    const std::shared_ptr<const RadialTable> inverse = inverse_square_table();
+    const presets::KineticBlob kinetic(glm::vec3(0.5f, -0.25f, 1.f), glm::vec3(0.f), 1.5f);
+    const RadialLUTMetaball sampled(inverse, kinetic.m_center, kinetic.m_scale);
+
+    const std::vector<glm::vec3> points = random_points(4096, 3.f);
+    std::vector<float> xs, ys, zs, out(points.size(), 1.f);
+    for (const glm::vec3& p : points) {
+        xs.push_back(p.x);
+        ys.push_back(p.y);
+        zs.push_back(p.z);
+    }
+    sampled.compute_batch(xs.data(), ys.data(), zs.data(), out.data(), points.size());
+
+    bool matches = sampled.max_error() == kinetic.m_scale * inverse->max_error();
+    for (size_t j = 0; j < points.size(); j++) {
+        const float r = glm::length(points[j] - kinetic.m_center);
+        const float value = sampled(points[j].x, points[j].y, points[j].z);
+        const float expected = kinetic(points[j].x, points[j].y, points[j].z);
+        matches = matches && out[j] == 1.f + value;
+        if (r >= CUTOFF) {
+            matches = matches && value == 0.f;
+        } else if (r > INNER) {
+            matches = matches && std::abs(value - expected) <= sampled.max_error();
+        }
+    }
+    return matches;
+}
+
+// Weighted axes stretch the table like `tune_blob` stretches the inverse square, & the bounds follow them
+bool axis_weights_test() {
+    const glm::vec3 weights(1.f, 4.f, 0.25f);
+    const glm::vec3 center(1.f, 0.f, -1.f);
+    const RadialLUTMetaball sampled(inverse_square_table(), center, 1.f, weights);
+    const auto tune_blob = [&](const glm::vec3& pt) {
+        const glm::vec3 d = center - pt;
+        return 1.f / (weights.x * d.x * d.x + weights.y * d.y * d.y + weights.z * d.z * d.z);
+    };
+
+    bool matches = sampled.get_support_radius() == CUTOFF * 2.f;
+    const BoundingBox box = sampled.get_bounding_box();
+    matches = matches && box.max_point == center + glm::vec3(CUTOFF, CUTOFF / 2.f, CUTOFF * 2.f)
+        && box.min_point == center - glm::vec3(CUTOFF, CUTOFF / 2.f, CUTOFF * 2.f);
+
+    for (const glm::vec3& p : random_points(4096, 6.f)) {
+        const float value = sampled(p.x, p.y, p.z);
+        const float q = 1.f / tune_blob(p);
+        if (q >= CUTOFF * CUTOFF) {
+            matches = matches && value == 0.f;
+        } else if (q > INNER * INNER) {
+            matches = matches && std::abs(value - tune_blob(p)) <= sampled.max_error();
+        }
+    }
+    return matches;
+}
+
+/** Triangle count & surface area of `mesh` */
+static glm::dvec2 measure(const common::graphics::MeshData& mesh) {
+    double area = 0.0;
+    for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3) {
+        const glm::vec3 a = mesh.vertices[mesh.indices[t]].position;
+        const glm::vec3 b = mesh.vertices[mesh.indices[t + 1]].position;
+        const glm::vec3 c = mesh.vertices[mesh.indices[t + 2]].position;
+        area += 0.5 * glm::length(glm::cross(b - a, c - a));
+    }
+    return glm::dvec2((double) mesh.indices.size() / 3, area);
+}
+
+// Meshes of sampled gaussians match meshes of the `Gaussian` preset
+bool same_mesh_test() {
+    const float variance = 1.5f;
+    const std::vector<glm::vec3> centers = { glm::vec3(-1.f, 0.f, 0.f), glm::vec3(1.f, 0.5f, 0.f), glm::vec3(0.f, -0.5f, 1.f) };
+
+    MetaballEngine<AggregateMetaball> exact(glm::vec3(0.f), 8.f, 64, ISOVALUE);
+    MetaballEngine<RadialLUTMetaball> sampled(glm::vec3(0.f), 8.f, 64, ISOVALUE);
+    const std::shared_ptr<const RadialTable> table = gaussian_table(variance);
+    for (const glm::vec3& c : centers) {
+        exact.add_metaball(Metaball([c, variance](float x, float y, float z) {
+            return presets::Gaussian { variance }(x - c.x, y - c.y, z - c.z);
+        }));
+        sampled.add_metaball(RadialLUTMetaball(table, c));
+    }
+
+    const glm::dvec2 expected = measure(exact.construct_mesh());
+    const glm::dvec2 result = measure(sampled.construct_mesh());
+    std::cout << "\t" << expected.x << " / " << result.x << " triangles, area " << expected.y << " / " << result.y << std::endl;
+    return expected.x > 0.0 && expected.x == result.x && std::abs(expected.y - result.y) < 1e-4 * expected.y;
+}
+
+// A costly custom falloff evaluates about as fast from a table as the inverse square blob
+bool evaluation_cost_test() {
+    const auto profile = [](const float q) { return expf(-q) * (1.f + cosf(3.f * sqrtf(q))) / (0.1f + q); };
+    const std::shared_ptr<const RadialTable> table = std::make_shared<const RadialTable>(profile, CUTOFF, 4096);
+    const std::vector<glm::vec3> centers = random_points(16, 2.f);
+
+    MetaballEngine<RadialLUTMetaball> sampled(glm::vec3(0.f), 6.f, 96, ISOVALUE);
+    MetaballEngine<Metaball<presets::InverseSquareBlob>> inverse(glm::vec3(0.f), 6.f, 96, ISOVALUE);
+    MetaballEngine<AggregateMetaball> direct(glm::vec3(0.f), 6.f, 96, ISOVALUE);
+    for (const glm::vec3& c : centers) {
+        sampled.add_metaball(RadialLUTMetaball(table, c));
+        inverse.add_metaball(Metaball(presets::InverseSquareBlob(c)));
+        direct.add_metaball(Metaball([c, profile](float x, float y, float z) {
+            const glm::vec3 d = c - glm::vec3(x, y, z);
+            return profile(glm::dot(d, d));
+        }));
+    }
+
+    const auto time_of = [](auto& engine) {
+        double best = 1e30;
+        for (int k = 0; k < 3; k++) {
+            const auto start = std::chrono::steady_clock::now();
+            engine.update_densities();
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    };
+
+    const double sampled_ms = time_of(sampled);
+    const double inverse_ms = time_of(inverse);
+    const double direct_ms = time_of(direct);
+    std::cout << "\ttable: " << sampled_ms << " ms, inverse square: " << inverse_ms << " ms, direct: " << direct_ms << " ms" << std::endl;
+    return sampled_ms < direct_ms;
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Table Error #1", table_error_test },
+        { "Matches Presets #1", matches_presets_test },
+        { "Axis Weights #1", axis_weights_test },
+        { "Same Mesh #1", same_mesh_test },
+        { "Evaluation Cost #1", evaluation_cost_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nRADIAL TABLE TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+#include <quantized_isosurface.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace mbl;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+static constexpr float ISOVALUE = 0.5f;
+
+static_assert(HasSeparableTerms<presets::Gaussian>::value);
+static_assert(HasSeparableTerms<presets::Gyroid>::value);
+static_assert(HasSeparableTerms<Metaball<presets::Gyroid>>::value);
+static_assert(!HasSeparableTerms<presets::InverseSquareBlob>::value);
+static_assert(!HasSeparableTerms<Metaball<presets::InverseSquareBlob>>::value);
+static_assert(!HasSeparableTerms<AggregateMetaball>::value);
+
+/** Gaussian counting the 1D factors it evaluates */
+struct CountingGaussian : public presets::Gaussian {
+    static inline size_t evaluated = 0;
+
+    void axis_factors(const size_t axis, const float* coordinates, const size_t n, float* factors) const {
+        evaluated += n;
+        presets::Gaussian::axis_factors(axis, coordinates, n, factors);
+    }
+};
+
+/** Same scalar function as `T`, hidden from the separable path */
+template <typename T>
+static AggregateMetaball opaque(const T& f) {
+    return AggregateMetaball([f](float x, float y, float z) { return f(x, y, z); });
+}
+
+static const std::vector<glm::vec3> GYROID_WEIGHTS = { glm::vec3(1.f), glm::vec3(0.5f, 1.f, 0.25f) };
+
+/** Largest difference between the densities of two fields over the same box */
+static float largest_difference(const IsoSurface& a, const IsoSurface& b) {
+    float largest = 0.f;
+    for (uint32_t i = 0; i < a.indices(); i++) {
+        largest = std::max(largest, std::abs(a.isopoints()[i].density - b.isopoints()[i].density));
+    }
+    return largest;
+}
+
+// Densities summed from per axis factors match the metaballs evaluated at every node
+bool same_densities_test() {
+    MetaballEngine<Metaball<presets::Gyroid>> separable(glm::vec3(0.3f, 0.f, -0.2f), 12.f, 48, ISOVALUE);
+    MetaballEngine<AggregateMetaball> direct(glm::vec3(0.3f, 0.f, -0.2f), 12.f, 48, ISOVALUE);
+    for (const glm::vec3& weights : GYROID_WEIGHTS) {
+        separable.add_metaball(Metaball(presets::Gyroid(weights)));
+        direct.add_metaball(opaque(presets::Gyroid(weights)));
+    }
+
+    MetaballEngine<Metaball<presets::Gaussian>> gaussians(glm::vec3(0.f), 6.f, 48, ISOVALUE);
+    MetaballEngine<AggregateMetaball> direct_gaussians(glm::vec3(0.f), 6.f, 48, ISOVALUE);
+    for (const float variance : { 0.5f, 2.f }) {
+        gaussians.add_metaball(Metaball(presets::Gaussian { variance }));
+        direct_gaussians.add_metaball(opaque(presets::Gaussian { variance }));
+    }
+
+    // Rows split between several threads, even on a single core machine
+    const uint32_t pool_workers = common::ThreadPool::shared().get_workers();
+    common::ThreadPool::shared().set_workers(3);
+    separable.set_workers(4);
+    separable.update_densities();
+    common::ThreadPool::shared().set_workers(pool_workers);
+    direct.update_densities();
+    gaussians.update_densities();
+    direct_gaussians.update_densities();
+
+    const float gyroid_error = largest_difference(separable.get_field(), direct.get_field());
+    const float gaussian_error = largest_difference(gaussians.get_field(), direct_gaussians.get_field());
+    std::cout << "\tgyroid: " << gyroid_error << ", gaussian: " << gaussian_error << " largest difference" << std::endl;
+    return gyroid_error < 1e-5f && gaussian_error < 1e-5f;
+}
+
+// Each ball evaluates its factors once per node coordinate of each axis, not once per node
+bool linear_factor_count_test() {
+    MetaballEngine<Metaball<CountingGaussian>> engine(glm::vec3(0.f), 6.f, 64, ISOVALUE);
+    engine.add_metaball(Metaball(CountingGaussian()));
+    engine.add_metaball(Metaball(CountingGaussian()));
+
+    CountingGaussian::evaluated = 0;
+    engine.update_densities();
+    const size_t per_axis = (size_t) engine.get_field().shape().x;
+    return CountingGaussian::evaluated == 2 * 3 * per_axis;
+}
+
+// Fields stored as 16 bit densities take the separable path too
+bool quantized_field_test() {
+    MetaballEngine<Metaball<presets::Gyroid>> engine(glm::vec3(0.f), 12.f, 48, ISOVALUE);
+    engine.add_metaball(Metaball(presets::Gyroid()));
+    engine.update_densities();
+
+    BasicIsoSurface<HalfDensity> half = BasicIsoSurface<HalfDensity>::construct(
+        engine.get_field().get_origin(), engine.get_field().half_extents(), engine.get_field().shape() - 1, HalfDensity { ISOVALUE });
+    engine.evaluate_field(half);
+
+    bool same = true;
+    for (uint32_t i = 0; i < half.indices(); i++) {
+        const float expected = engine.get_field().isopoints()[i].density;
+        same = same && std::abs(half.get_density(i) - expected) <= 1e-3f && (half.get_density(i) >= ISOVALUE) == (expected >= ISOVALUE);
+    }
+    return same;
+}
+
+// The gyroid scene meshes as it does when evaluated node by node, in less time
+bool gyroid_mesh_test() {
+    MetaballEngine<Metaball<presets::Gyroid>> separable(glm::vec3(0.f), 12.f, 96, ISOVALUE);
+    MetaballEngine<AggregateMetaball> direct(glm::vec3(0.f), 12.f, 96, ISOVALUE);
+    for (const glm::vec3& weights : GYROID_WEIGHTS) {
+        separable.add_metaball(Metaball(presets::Gyroid(weights)));
+        direct.add_metaball(opaque(presets::Gyroid(weights)));
+    }
+
+    const auto time_of = [](auto& engine) {
+        double best = 1e30;
+        for (int k = 0; k < 3; k++) {
+            const auto start = std::chrono::steady_clock::now();
+            engine.update_densities();
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    };
+    const double separable_ms = time_of(separable);
+    const double direct_ms = time_of(direct);
+
+    const size_t separable_triangles = separable.construct_mesh().indices.size() / 3;
+    const size_t direct_triangles = direct.construct_mesh().indices.size() / 3;
+    std::cout << "\t" << separable_triangles << " / " << direct_triangles << " triangles, separable: " << separable_ms
+        << " ms, per node: " << direct_ms << " ms" << std::endl;
+    return direct_triangles > 0 && separable_triangles == direct_triangles && separable_ms < direct_ms;
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Same Densities #1", same_densities_test },
+        { "Linear Factor Count #1", linear_factor_count_test },
+        { "Quantized Field #1", quantized_field_test },
+        { "Gyroid Mesh #1", gyroid_mesh_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nSEPARABLE KERNEL TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
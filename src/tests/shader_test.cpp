@@ -0,0 +1,126 @@
+#include "../Shader.hpp"
+#include "gl_context.hpp"
+
+#include <iostream>
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+static const char* VERTEX_SOURCE = R"(#version 330 core
+uniform mat4 model;
+uniform vec3 tint;
+uniform float scale;
+layout (location = 0) in vec3 position;
+out vec3 color;
+void main() {
+    color = tint;
+    gl_Position = model * vec4(scale * position, 1.0);
+}
+)";
+
+static const char* FRAGMENT_SOURCE = R"(#version 330 core
+in vec3 color;
+out vec4 frag;
+void main() {
+    frag = vec4(color, 1.0);
+}
+)";
+
+static glm::vec3 tint_of(const Shader& shader) {
+    glm::vec3 tint(0.f);
+    glGetUniformfv(shader.get_program_id(), glGetUniformLocation(shader.get_program_id(), "tint"), &tint.x);
+    return tint;
+}
+
+// Asking for a uniform twice gives the same handle, other names & unknown names get their own
+bool slot_dedupe_test() {
+    std::optional<Shader> shader = Shader::from_string(VERTEX_SOURCE, FRAGMENT_SOURCE);
+    if (!shader) {
+        return false;
+    }
+
+    const UniformHandle<glm::vec3> tint = shader->uniform<glm::vec3>("tint");
+    const UniformHandle<glm::vec3> again = shader->uniform<glm::vec3>("tint");
+    const UniformHandle<float> scale = shader->uniform<float>("scale");
+    const UniformHandle<float> missing = shader->uniform<float>("not_a_uniform");
+
+    // Values set on a uniform the program doesn't have are never sent
+    shader->set_uniform(missing, 2.f);
+    return tint.slot == again.slot && scale.slot != tint.slot && missing.slot != scale.slot
+        && shader->pending_uniforms() == 0;
+}
+
+// Only values that changed wait for the next `use`, each once however often it's set
+bool value_caching_test() {
+    std::optional<Shader> shader = Shader::from_string(VERTEX_SOURCE, FRAGMENT_SOURCE);
+    if (!shader) {
+        return false;
+    }
+
+    const UniformHandle<glm::vec3> tint = shader->uniform<glm::vec3>("tint");
+    const UniformHandle<float> scale = shader->uniform<float>("scale");
+    shader->set_uniform(tint, glm::vec3(1.f, 0.f, 0.f)).set_uniform(tint, glm::vec3(0.f, 1.f, 0.f));
+    shader->set_uniform(scale, 2.f);
+    const bool both_pending = shader->pending_uniforms() == 2;
+
+    shader->use();
+    const bool sent = shader->pending_uniforms() == 0 && tint_of(*shader) == glm::vec3(0.f, 1.f, 0.f);
+
+    shader->set_uniform(tint, glm::vec3(0.f, 1.f, 0.f)).set_uniform(scale, 2.f);
+    const bool unchanged_skipped = shader->pending_uniforms() == 0;
+
+    shader->set_uniform(scale, 3.f);
+    return both_pending && sent && unchanged_skipped && shader->pending_uniforms() == 1 && glGetError() == GL_NO_ERROR;
+}
+
+// A program bound outside of Shader doesn't receive another shader's values, & stays bound
+bool foreign_program_test() {
+    std::optional<Shader> shader = Shader::from_string(VERTEX_SOURCE, FRAGMENT_SOURCE);
+    std::optional<Shader> other = Shader::from_string(VERTEX_SOURCE, FRAGMENT_SOURCE);
+    if (!shader || !other) {
+        return false;
+    }
+
+    const UniformHandle<glm::vec3> tint = shader->uniform<glm::vec3>("tint");
+    shader->use();
+    glUseProgram(other->get_program_id());
+
+    shader->set_uniform(tint, glm::vec3(0.25f, 0.5f, 0.75f)).flush_uniforms();
+
+    GLint bound = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &bound);
+    glUseProgram(0);
+    return tint_of(*shader) == glm::vec3(0.25f, 0.5f, 0.75f) && tint_of(*other) == glm::vec3(0.f)
+        && (GLuint) bound == other->get_program_id() && glGetError() == GL_NO_ERROR;
+}
+
+int main() {
+    glfwSetErrorCallback([](int, const char*) {});
+    GLFWwindow* win = gl_context::open_hidden_context();
+    if (win == nullptr) {
+        std::cout << "SHADER TESTS: no OpenGL context available, skipped." << std::endl;
+        return gl_context::SKIPPED;
+    }
+
+    TestItem tests[] = {
+        { "Slot Dedupe #1", slot_dedupe_test },
+        { "Value Caching #1", value_caching_test },
+        { "Foreign Program #1", foreign_program_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nSHADER TESTS (" << glGetString(GL_RENDERER) << ")\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    glfwDestroyWindow(win);
+    glfwTerminate();
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
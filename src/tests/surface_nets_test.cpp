@@ -0,0 +1,115 @@
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+#include "test_scenes.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <utility>
+
+using namespace mbl;
+using namespace test_scenes;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+/** Fraction of the triangles of `mesh` with an angle under 10 degrees */
+static float sliver_fraction(const common::graphics::MeshData& mesh) {
+    size_t slivers = 0;
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        const glm::vec3 p[3] = {
+            mesh.vertices[mesh.indices[i]].position,
+            mesh.vertices[mesh.indices[i + 1]].position,
+            mesh.vertices[mesh.indices[i + 2]].position
+        };
+
+        float min_cosine_angle = 0.f;
+        for (size_t v = 0; v < 3; v++) {
+            const glm::vec3 a = p[(v + 1) % 3] - p[v];
+            const glm::vec3 b = p[(v + 2) % 3] - p[v];
+            const float length = glm::length(a) * glm::length(b);
+            min_cosine_angle = std::max(min_cosine_angle, length > 0.f ? glm::dot(a, b) / length : 1.f);
+        }
+        slivers += (size_t) (min_cosine_angle > std::cos(glm::radians(10.f)));
+    }
+    return (float) slivers / (float) (mesh.indices.size() / 3);
+}
+
+// Every edge is shared by exactly two triangles, once in each direction
+bool watertight_test() {
+    KineticEngine engine = make_still_engine(ExtractionBackend::SurfaceNets);
+    const common::graphics::MeshData& mesh = engine.construct_mesh();
+
+    std::map<std::pair<int32_t, int32_t>, int32_t> directed_edges;
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        for (size_t v = 0; v < 3; v++) {
+            directed_edges[{ mesh.indices[i + v], mesh.indices[i + (v + 1) % 3] }] += 1;
+        }
+    }
+
+    bool closed = !directed_edges.empty();
+    for (const auto& [edge, uses] : directed_edges) {
+        const auto opposite = directed_edges.find({ edge.second, edge.first });
+        closed = closed && uses == 1 && opposite != directed_edges.end() && opposite->second == 1;
+    }
+    return closed;
+}
+
+// Triangles face the same way as marching cubes' (against the vertex normals' winding) & vertices lie on the surface
+bool orientation_test() {
+    KineticEngine engine = make_still_engine(ExtractionBackend::SurfaceNets);
+    const common::graphics::MeshData& mesh = engine.construct_mesh();
+
+    bool agrees = !mesh.indices.empty();
+    for (size_t i = 0; agrees && i + 2 < mesh.indices.size(); i += 3) {
+        const common::graphics::Vertex& a = mesh.vertices[mesh.indices[i]];
+        const common::graphics::Vertex& b = mesh.vertices[mesh.indices[i + 1]];
+        const common::graphics::Vertex& c = mesh.vertices[mesh.indices[i + 2]];
+        const glm::vec3 winding = glm::cross(b.position - a.position, c.position - a.position);
+        agrees = glm::dot(winding, a.normal + b.normal + c.normal) < 0.f;
+    }
+
+    // Each vertex sits near the isosurface with a unit normal
+    for (const common::graphics::Vertex& v : mesh.vertices) {
+        agrees = agrees && std::fabs(engine.sum_metaballs(v.position) - 1.f) < 1.f && glm::length(v.normal) > 0.99f;
+    }
+    return agrees;
+}
+
+// Far fewer vertices & slivers than marching cubes
+bool smaller_test() {
+    KineticEngine nets = make_still_engine(ExtractionBackend::SurfaceNets);
+    KineticEngine marched = make_still_engine(ExtractionBackend::MarchingCubes);
+    const common::graphics::MeshData& a = nets.construct_mesh();
+    const common::graphics::MeshData& b = marched.construct_mesh();
+
+    const float nets_slivers = sliver_fraction(a);
+    const float marched_slivers = sliver_fraction(b);
+    std::cout << "\tsurface nets: " << a.vertices.size() << " vertices, " << a.indices.size() / 3 << " triangles, "
+        << nets_slivers * 100.f << "% slivers; marching cubes: " << b.vertices.size() << " vertices, "
+        << b.indices.size() / 3 << " triangles, " << marched_slivers * 100.f << "% slivers" << std::endl;
+    return a.vertices.size() * 5 < b.vertices.size() && nets_slivers * 4 < marched_slivers;
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Watertight #1", watertight_test },
+        { "Orientation #1", orientation_test },
+        { "Smaller #1", smaller_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nSURFACE NETS TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/** The scene most tests mesh, & the helpers they animate & compare its meshes with */
+namespace test_scenes {
+    using KineticEngine = mbl::MetaballEngine<mbl::Metaball<mbl::presets::KineticBlob>>;
+
+    /** Adds three kinetic blobs around the origin, merging at isovalue 1. Their velocities only
+     * matter to tests that `step` them. */
+    inline void add_three_blobs(KineticEngine& engine) {
+        using mbl::presets::KineticBlob;
+        engine.add_metaball(mbl::Metaball(KineticBlob(glm::vec3(-2.f, 0.f, 0.f), glm::vec3(1.f, 0.2f, 0.f))));
+        engine.add_metaball(mbl::Metaball(KineticBlob(glm::vec3(1.5f, 0.5f, 0.f), glm::vec3(-0.5f, 0.f, 0.5f))));
+        engine.add_metaball(mbl::Metaball(KineticBlob(glm::vec3(0.f, -2.f, 1.f), glm::vec3(0.f, 1.f, -0.3f))));
+    }
+
+    /** The three blobs in a 10 unit cube of `resolution` cells per axis around the origin, at isovalue 1 */
+    inline KineticEngine make_engine(const int32_t resolution = 60, const mbl::ExtractionMode mode = mbl::ExtractionMode::FullScan) {
+        KineticEngine engine(glm::vec3(0.f), 10.f, resolution, 1.f);
+        add_three_blobs(engine);
+        engine.set_extraction_mode(mode);
+        return engine;
+    }
+
+    /** Three still blobs whose centers sit off the field's nodes, so no node lands on a center */
+    inline void add_still_blobs(KineticEngine& engine) {
+        using mbl::presets::KineticBlob;
+        engine.add_metaball(mbl::Metaball(KineticBlob(glm::vec3(-2.1f, 0.13f, 0.07f))));
+        engine.add_metaball(mbl::Metaball(KineticBlob(glm::vec3(1.37f, 0.52f, -0.21f))));
+        engine.add_metaball(mbl::Metaball(KineticBlob(glm::vec3(0.11f, -2.03f, 1.19f))));
+    }
+
+    /** The still blobs in a 10 unit cube around the origin at isovalue 1, extracted by `backend` on up to `workers` threads */
+    inline KineticEngine make_still_engine(const mbl::ExtractionBackend backend, const uint32_t workers = 1, const int32_t resolution = 80) {
+        KineticEngine engine(glm::vec3(0.f), 10.f, resolution, 1.f);
+        add_still_blobs(engine);
+        engine.set_extraction_backend(backend, workers);
+        return engine;
+    }
+
+    /** Moves every blob along its velocity for `dt` seconds */
+    inline void step(KineticEngine& engine, const float dt) {
+        for (size_t i = 0; i < engine.num_metaballs(); i++) {
+            engine.update_metaball(engine.handle_of(i), [dt](mbl::Metaball<mbl::presets::KineticBlob>& m) { m.unwrap().update(dt); });
+        }
+    }
+
+    /** Triangles of `mesh` as sorted position triples, so meshes built in different cell orders compare equal */
+    inline std::vector<std::array<float, 9>> triangles_of(const mbl::common::graphics::MeshData& mesh) {
+        std::vector<std::array<float, 9>> triangles;
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+            std::array<float, 9> t;
+            for (size_t v = 0; v < 3; v++) {
+                const glm::vec3& p = mesh.vertices[mesh.indices[i + v]].position;
+                t[3 * v] = p.x;
+                t[3 * v + 1] = p.y;
+                t[3 * v + 2] = p.z;
+            }
+            triangles.push_back(t);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    /** True when every triangle of `a` has one of `b` with each corner, in the same order, within `tolerance`
+     * per coordinate, & the other way around. Marching cubes may interpolate a shared edge from either end,
+     * & fields of different shapes place the same node with different rounding, so meshes built along
+     * different paths agree only to within a few ulps. */
+    inline bool same_triangles(const mbl::common::graphics::MeshData& a, const mbl::common::graphics::MeshData& b, const float tolerance = 1e-4f) {
+        const std::vector<std::array<float, 9>> ta = triangles_of(a);
+        const std::vector<std::array<float, 9>> tb = triangles_of(b);
+        if (ta.size() != tb.size()) {
+            return false;
+        }
+
+        // Both are sorted by their first coordinate, a match can only sit within `tolerance` of it
+        std::vector<bool> matched(tb.size(), false);
+        for (const std::array<float, 9>& t : ta) {
+            auto candidate = std::lower_bound(tb.begin(), tb.end(), t[0] - tolerance,
+                [](const std::array<float, 9>& u, const float x) { return u[0] < x; });
+            bool found = false;
+            for (; !found && candidate != tb.end() && (*candidate)[0] <= t[0] + tolerance; ++candidate) {
+                const size_t j = (size_t) (candidate - tb.begin());
+                found = !matched[j];
+                for (size_t k = 0; found && k < 9; k++) {
+                    found = std::fabs((*candidate)[k] - t[k]) <= tolerance;
+                }
+                if (found) {
+                    matched[j] = true;
+                }
+            }
+            if (!found) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
\ No newline at end of file
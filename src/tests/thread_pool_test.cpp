@@ -0,0 +1,139 @@
+#include <common/thread_pool.hpp>
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+#include "test_scenes.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace mbl;
+using common::TaskGroup;
+using common::ThreadPool;
+using test_scenes::KineticEngine;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+// Every index is visited exactly once, whatever the grain
+bool covers_range_test() {
+    ThreadPool pool(3);
+    bool covered = true;
+    for (const int64_t grain : { 1, 7, 1000, 5000 }) {
+        std::vector<std::atomic<int32_t>> visits(4321);
+        pool.parallel_for(0, (int64_t) visits.size(), [&visits](const int64_t low, const int64_t high) {
+            for (int64_t i = low; i < high; i++) {
+                visits[i].fetch_add(1);
+            }
+        }, grain);
+        for (const std::atomic<int32_t>& v : visits) {
+            covered = covered && v.load() == 1;
+        }
+    }
+
+    std::atomic<int64_t> nodes = 0;
+    pool.parallel_for(FieldRange({ 0, 5, 0, 6, 0, 7 }), [&nodes](const FieldRange& slab) {
+        const IndexDim size = slab.high() - slab.low();
+        nodes.fetch_add(size.x == 5 && size.y == 6 ? size.z * 30 : -1000);
+    });
+    return covered && nodes.load() == 5 * 6 * 7;
+}
+
+// Tasks can wait on groups of their own without the pool running out of threads
+bool nested_groups_test() {
+    ThreadPool pool(2);
+    std::atomic<int64_t> sum = 0;
+    TaskGroup outer(pool);
+    for (int64_t i = 0; i < 16; i++) {
+        outer.run([&pool, &sum, i] {
+            TaskGroup inner(pool);
+            for (int64_t j = 0; j < 16; j++) {
+                inner.run([&sum, i, j] { sum.fetch_add(i * 16 + j); });
+            }
+            inner.wait();
+        });
+    }
+    outer.wait();
+    return sum.load() == 255 * 256 / 2;
+}
+
+// Pools can be resized between uses, & one without workers runs everything on the caller
+bool resize_test() {
+    ThreadPool pool(0);
+    int64_t serial_sum = 0;     // not atomic, only the caller touches it
+    pool.parallel_for(0, 100, [&serial_sum](const int64_t low, const int64_t high) {
+        for (int64_t i = low; i < high; i++) {
+            serial_sum += i;
+        }
+    });
+
+    pool.set_workers(3);
+    std::atomic<int64_t> sum = 0;
+    pool.parallel_for(0, 100, [&sum](const int64_t low, const int64_t high) {
+        for (int64_t i = low; i < high; i++) {
+            sum.fetch_add(i);
+        }
+    });
+    return serial_sum == 4950 && sum.load() == 4950 && pool.get_workers() == 3 && pool.concurrency() == 4;
+}
+
+// Densities evaluated across the shared pool are exactly the serial ones
+bool parallel_densities_test() {
+    ThreadPool::shared().set_workers(3);
+    KineticEngine serial(glm::vec3(0.f), 10.f, 80, 1.f);
+    KineticEngine parallel(glm::vec3(0.f), 10.f, 80, 1.f);
+    parallel.set_workers(4);
+    for (KineticEngine* engine : { &serial, &parallel }) {
+        test_scenes::add_three_blobs(*engine);
+        engine->update_densities();
+    }
+
+    bool equal = true;
+    for (size_t i = 0; i < serial.get_field().indices(); i++) {
+        equal = equal && serial.get_field().get((uint32_t) i).density == parallel.get_field().get((uint32_t) i).density;
+    }
+    return equal;
+}
+
+// A small parallel_for runs both of its chunks on every dispatch. Its cost depends on the machine's
+// load, so it is only reported here, `eb` holds it to a limit
+bool dispatch_overhead_test() {
+    ThreadPool pool(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    std::atomic<int64_t> sink = 0;
+    std::vector<double> times;
+    for (int i = 0; i < 1000; i++) {
+        const auto start = std::chrono::steady_clock::now();
+        pool.parallel_for(0, 2, [&sink](const int64_t low, const int64_t) { sink.fetch_add(low); });
+        times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+
+    std::cout << "\tmedian dispatch: " << times[times.size() / 2] << " us" << std::endl;
+    return sink.load() == 1000;
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Covers Range #1", covers_range_test },
+        { "Nested Groups #1", nested_groups_test },
+        { "Resize #1", resize_test },
+        { "Parallel Densities #1", parallel_densities_test },
+        { "Dispatch Overhead #1", dispatch_overhead_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nTHREAD POOL TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,179 @@
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+#include "test_scenes.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <vector>
+
+using namespace mbl;
+using namespace test_scenes;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+// Over many slowly moving frames, the tracked mesh is exactly the full scan's mesh
+bool matches_full_scan_test() {
+    KineticEngine tracked = make_engine(60, ExtractionMode::Tracking);
+    KineticEngine scanned = make_engine(60, ExtractionMode::FullScan);
+    tracked.set_tracking_options(1000, 2);
+
+    bool equal = true;
+    size_t tracked_frames = 0;
+    for (int frame = 0; frame < 30; frame++) {
+        step(tracked, 0.05f);
+        step(scanned, 0.05f);
+        equal = equal && triangles_of(tracked.construct_mesh()) == triangles_of(scanned.construct_mesh());
+        tracked_frames += (size_t) !tracked.get_extraction_stats().full_scan;
+    }
+    return equal && tracked_frames == 29;
+}
+
+// A tracked mesh only touches cells near the surface
+bool sparse_cost_test() {
+    KineticEngine engine = make_engine(60, ExtractionMode::Tracking);
+    engine.construct_mesh();
+    const ExtractionStats full = engine.get_extraction_stats();
+
+    step(engine, 0.05f);
+    engine.construct_mesh();
+    const ExtractionStats tracked = engine.get_extraction_stats();
+
+    std::cout << "\tfull scan: " << full.cells_visited << " cells, " << full.densities_computed << " densities; tracked: "
+        << tracked.cells_visited << " cells, " << tracked.densities_computed << " densities" << std::endl;
+    return full.full_scan && !tracked.full_scan
+        && tracked.cells_visited * 5 < full.cells_visited
+        && tracked.densities_computed * 5 < full.densities_computed;
+}
+
+// New metaballs, teleports, isovalue changes & the periodic interval all force a full scan
+bool fallback_test() {
+    KineticEngine engine = make_engine(60, ExtractionMode::Tracking);
+    engine.set_tracking_options(3, 2);
+    engine.construct_mesh();
+
+    bool fell_back = true;
+    auto expect_full_scan = [&](const bool expected) {
+        engine.construct_mesh();
+        fell_back = fell_back && engine.get_extraction_stats().full_scan == expected;
+    };
+
+    step(engine, 0.05f);
+    expect_full_scan(false);
+
+    engine.add_metaball(Metaball(presets::KineticBlob(glm::vec3(3.f, 3.f, 3.f))));
+    expect_full_scan(true);
+
+    engine.update_metaball(engine.handle_of(0), [](Metaball<presets::KineticBlob>& m) { m.unwrap().m_center += glm::vec3(2.f, 0.f, 0.f); });
+    expect_full_scan(true);
+
+    engine.set_isovalue(1.5f);
+    expect_full_scan(true);
+
+    for (int frame = 0; frame < 3; frame++) {
+        step(engine, 0.05f);
+        expect_full_scan(false);
+    }
+    step(engine, 0.05f);
+    expect_full_scan(true);
+
+    return fell_back;
+}
+
+// Nested shells still see every density after a tracked (sparse) mesh
+bool shells_after_tracking_test() {
+    KineticEngine tracked = make_engine(60, ExtractionMode::Tracking);
+    KineticEngine scanned = make_engine(60, ExtractionMode::FullScan);
+    tracked.construct_mesh();
+    step(tracked, 0.05f);
+    step(scanned, 0.05f);
+    tracked.construct_mesh();
+
+    const std::vector<float> isovalues = { 0.5f, 2.f };
+    const std::vector<common::graphics::MeshData>& a = tracked.construct_meshes(isovalues);
+    const std::vector<common::graphics::MeshData>& b = scanned.construct_meshes(isovalues);
+    return triangles_of(a[0]) == triangles_of(b[0]) && triangles_of(a[1]) == triangles_of(b[1]);
+}
+
+// Every shell marched in the one pass matches the cube bits of each cube against its isovalue & the mesh
+// `construct_mesh` makes at that isovalue, including an isovalue exactly equal to a node's density
+bool shells_match_cube_bits_test() {
+    KineticEngine engine = make_engine(60, ExtractionMode::FullScan);
+    engine.construct_mesh();
+    IsoSurface field = engine.get_field();
+    const float node_density = field.isopoints()[field.indices() / 2].density;
+
+    const std::vector<float> isovalues = { 0.5f, node_density, 2.f };
+    const std::vector<common::graphics::MeshData> shells = engine.construct_meshes(isovalues);
+
+    bool equal = node_density > 0.f && shells.size() == isovalues.size();
+    for (size_t layer = 0; equal && layer < isovalues.size(); layer++) {
+        size_t expected = 0;
+        CubeOrderedIsopoints cube_isopoints;
+        MarchingCubeRange cubes(field);
+        for (CubeView view : cubes) {
+            const uint8_t cube_bits = engine.compute_cube_bits(view, cube_isopoints, isovalues[layer]).cube_bits;
+            for (int32_t k = 0; k < 16 && triTable[cube_bits][k] != -1; k += 3) {
+                expected += 1;
+            }
+        }
+
+        engine.set_isovalue(isovalues[layer]);
+        equal = expected > 0 && shells[layer].indices.size() == 3 * expected
+            && triangles_of(shells[layer]) == triangles_of(engine.construct_mesh());
+    }
+    return equal;
+}
+
+// Seeded meshes are exactly the full scan's mesh, frame after frame
+bool seeded_matches_full_scan_test() {
+    KineticEngine seeded = make_engine(60, ExtractionMode::Seeded);
+    KineticEngine scanned = make_engine(60, ExtractionMode::FullScan);
+
+    bool equal = true;
+    for (int frame = 0; frame < 30; frame++) {
+        step(seeded, 0.1f);
+        step(scanned, 0.1f);
+        equal = equal && triangles_of(seeded.construct_mesh()) == triangles_of(scanned.construct_mesh())
+            && !seeded.get_extraction_stats().full_scan;
+    }
+    return equal;
+}
+
+// Seeding from the centers never evaluates the empty parts of the field
+bool seeded_sparse_cost_test() {
+    KineticEngine engine = make_engine(60, ExtractionMode::Seeded);
+    engine.construct_mesh();
+    const ExtractionStats seeded = engine.get_extraction_stats();
+
+    const size_t nodes = 61 * 61 * 61;
+    std::cout << "\tseeded: " << seeded.cells_visited << " cells, " << seeded.densities_computed << " densities of " << nodes << std::endl;
+    return !seeded.full_scan && seeded.densities_computed * 10 < nodes;
+}
+
+int main() {
+    TestItem tests[] = {
+        { "Matches Full Scan #1", matches_full_scan_test },
+        { "Sparse Cost #1", sparse_cost_test },
+        { "Fallback #1", fallback_test },
+        { "Shells After Tracking #1", shells_after_tracking_test },
+        { "Shells Match Cube Bits #1", shells_match_cube_bits_test },
+        { "Seeded Matches Full Scan #1", seeded_matches_full_scan_test },
+        { "Seeded Sparse Cost #1", seeded_sparse_cost_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nSPARSE EXTRACTION TESTS\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "../MeshUploader.hpp"
+#include "gl_context.hpp"
+
+#include <engine.hpp>
+#include <metaball_presets.hpp>
+
+#include <iostream>
+#include <vector>
+
+using namespace mbl;
+using KineticEngine = MetaballEngine<Metaball<presets::KineticBlob>>;
+
+struct TestItem { const char* test_name; bool (*test_func)(); };
+
+static KineticEngine make_engine() {
+    KineticEngine engine(glm::vec3(0.f), 10.f, 20, 1.f);
+    engine.add_metaball(Metaball(presets::KineticBlob(glm::vec3(-1.f, 0.f, 0.f), glm::vec3(1.f, 0.f, 0.f))));
+    engine.add_metaball(Metaball(presets::KineticBlob(glm::vec3(1.f, 0.f, 0.f), glm::vec3(0.f, 1.f, 0.f))));
+    return engine;
+}
+
+/** Reads the last uploaded mesh back out of the uploader's buffers & compares it to `mesh` */
+static bool matches_gpu(const MeshUploader& uploader, const common::graphics::MeshData& mesh) {
+    std::vector<common::graphics::Vertex> vertices(mesh.vertices.size());
+    std::vector<int32_t> indices(mesh.indices.size());
+
+    glBindBuffer(GL_ARRAY_BUFFER, uploader.vertex_buffer());
+    glGetBufferSubData(GL_ARRAY_BUFFER, (GLintptr) uploader.vertex_offset(),
+        (GLsizeiptr) (vertices.size() * sizeof(common::graphics::Vertex)), vertices.data());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, uploader.index_buffer());
+    glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, (GLintptr) uploader.index_offset(),
+        (GLsizeiptr) (indices.size() * sizeof(int32_t)), indices.data());
+
+    bool equal = uploader.count() == mesh.indices.size() && indices == mesh.indices;
+    for (size_t i = 0; equal && i < vertices.size(); i++) {
+        equal = vertices[i].position == mesh.vertices[i].position && vertices[i].normal == mesh.vertices[i].normal;
+    }
+    return equal && glGetError() == GL_NO_ERROR;
+}
+
+// Uploads through either strategy land in the buffers untouched
+static bool round_trip(const MeshUploader::Strategy strategy) {
+    KineticEngine engine = make_engine();
+    MeshUploader uploader(strategy);
+
+    bool equal = true;
+    for (int frame = 0; frame < 5; frame++) {
+        engine.update_metaball(engine.handle_of(0), [](Metaball<presets::KineticBlob>& m) { m.unwrap().update(0.1f); });
+        const common::graphics::MeshData& mesh = engine.construct_mesh();
+        uploader.upload(mesh, engine.get_mesh_revision());
+        equal = equal && matches_gpu(uploader, mesh);
+    }
+    return equal;
+}
+
+bool orphan_round_trip_test() {
+    return round_trip(MeshUploader::Strategy::Orphan);
+}
+
+bool mapped_ring_round_trip_test() {
+    return round_trip(MeshUploader::Strategy::MappedRing);
+}
+
+// A mesh with an unchanged revision isn't uploaded again
+bool unchanged_skipped_test() {
+    KineticEngine engine = make_engine();
+    MeshUploader uploader(MeshUploader::Strategy::MappedRing);
+
+    const common::graphics::MeshData& mesh = engine.construct_mesh();
+    const bool first = uploader.upload(mesh, engine.get_mesh_revision());
+    const size_t offset = uploader.vertex_offset();
+
+    engine.construct_mesh();
+    const bool second = uploader.upload(mesh, engine.get_mesh_revision());
+    return first && !second && uploader.vertex_offset() == offset;
+}
+
+// Buffers double when a mesh outgrows them & never shrink
+bool capacity_doubles_test() {
+    MeshUploader uploader;
+    std::vector<common::graphics::Vertex> vertices(10);
+    std::vector<int32_t> indices(30, 0);
+    common::graphics::MeshData mesh { vertices, indices };
+
+    uploader.upload(mesh, 1);
+    const size_t small_capacity = uploader.vertex_buffer_capacity();
+
+    mesh.vertices.resize(small_capacity / sizeof(common::graphics::Vertex) + 1);
+    uploader.upload(mesh, 2);
+    const size_t large_capacity = uploader.vertex_buffer_capacity();
+
+    mesh.vertices.resize(10);
+    uploader.upload(mesh, 3);
+
+    return large_capacity >= 2 * small_capacity
+        && uploader.vertex_buffer_capacity() == large_capacity
+        && glGetError() == GL_NO_ERROR;
+}
+
+// A ring whose index buffer alone outgrows its segments still round trips after draws are in flight
+bool ring_index_growth_test() {
+    MeshUploader uploader(MeshUploader::Strategy::MappedRing);
+    std::vector<common::graphics::Vertex> vertices(10);
+    for (size_t i = 0; i < vertices.size(); i++) {
+        vertices[i].position = glm::vec3((float) i, 0.f, 0.f);
+    }
+    common::graphics::MeshData mesh { vertices, std::vector<int32_t>(30, 0) };
+
+    bool equal = true;
+    uint64_t revision = 1;
+    for (int frame = 0; frame < 4; frame++) {
+        mesh.indices[0] = frame;
+        uploader.upload(mesh, revision++);
+        equal = equal && matches_gpu(uploader, mesh);
+        uploader.draw();
+    }
+    const size_t vertex_capacity = uploader.vertex_buffer_capacity();
+    const size_t index_capacity = uploader.index_buffer_capacity();
+
+    mesh.indices.resize(index_capacity / sizeof(int32_t) + 1, 9);
+    for (int frame = 0; frame < 4; frame++) {
+        mesh.vertices[0].position.y = (float) frame;
+        uploader.upload(mesh, revision++);
+        equal = equal && matches_gpu(uploader, mesh);
+        uploader.draw();
+    }
+
+    return equal
+        && uploader.vertex_buffer_capacity() == vertex_capacity
+        && uploader.index_buffer_capacity() >= 2 * index_capacity
+        && glGetError() == GL_NO_ERROR;
+}
+
+int main() {
+    glfwSetErrorCallback([](int, const char*) {});
+    GLFWwindow* win = gl_context::open_hidden_context();
+    if (win == nullptr) {
+        std::cout << "UPLOADER TESTS: no OpenGL context available, skipped." << std::endl;
+        return gl_context::SKIPPED;
+    }
+
+    GLuint vao;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    TestItem tests[] = {
+        { "Orphan Round Trip #1", orphan_round_trip_test },
+        { "Mapped Ring Round Trip #1", mapped_ring_round_trip_test },
+        { "Unchanged Skipped #1", unchanged_skipped_test },
+        { "Capacity Doubles #1", capacity_doubles_test },
+        { "Ring Index Growth #1", ring_index_growth_test }
+    };
+
+    size_t successes = 0;
+    size_t count = 0;
+
+    std::cout << "========================\nUPLOADER TESTS (" << glGetString(GL_RENDERER) << ")\n========================" << std::endl;
+    for (TestItem& t : tests) {
+        const bool passed = t.test_func();
+        std::cout << t.test_name << ": " << (passed ? "PASS!" : "FAIL...") << std::endl;
+
+        successes += (size_t) passed;
+        count += 1;
+    }
+    std::cout << "========================\n" << successes << "/" << count << " correct.\n========================" << std::endl;
+
+    glDeleteVertexArrays(1, &vao);
+    glfwDestroyWindow(win);
+    glfwTerminate();
+    return successes == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file